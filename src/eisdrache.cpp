@@ -42,6 +42,13 @@ Eisdrache::Ty::Ptr Eisdrache::Ty::create(Eisdrache::Ptr eisdrache, Type *llvmTy)
         case Type::PointerTyID: 
             that = std::make_shared<PtrTy>(eisdrache, eisdrache->getVoidTy()); 
             break;
+        case Type::FixedVectorTyID:
+        case Type::ScalableVectorTyID: {
+            VectorType *vectorTy = dyn_cast<VectorType>(llvmTy);
+            that = std::make_shared<VectorTy>(eisdrache, Ty::create(eisdrache, vectorTy->getElementType()), 
+                vectorTy->getElementCount().getKnownMinValue(), vectorTy->getElementCount().isScalable());
+            break;
+        }
         case Type::StructTyID:
             Eisdrache::complain("Eisdrache::Ty::Ty(): Can not construct Eisdrache::Ty from a llvm::Type with ID: Type::StructTyID.");
         case Type::FunctionTyID:
@@ -63,11 +70,19 @@ size_t Eisdrache::Ty::getBit() const { return 0; }
 
 constexpr bool Eisdrache::Ty::isPtrTy() const { return kind() == PTR; }
 
-constexpr bool Eisdrache::Ty::isIntTy() const { return kind() == INT; }
+constexpr bool Eisdrache::Ty::isIntTy() const { 
+    return kind() == INT || (kind() == VECTOR && static_cast<const VectorTy *>(this)->getElementTy()->isIntTy()); 
+}
+
+constexpr bool Eisdrache::Ty::isFloatTy() const { 
+    return kind() == FLOAT || (kind() == VECTOR && static_cast<const VectorTy *>(this)->getElementTy()->isFloatTy()); 
+}
 
-constexpr bool Eisdrache::Ty::isFloatTy() const { return kind() == FLOAT; }
+constexpr bool Eisdrache::Ty::isVectorTy() const { return kind() == VECTOR; }
 
 constexpr bool Eisdrache::Ty::isSignedTy() { 
+    if (kind() == VECTOR)
+        return static_cast<VectorTy *>(this)->getElementTy()->isSignedTy();
     return kind() == FLOAT || (kind() == INT && dynamic_cast<IntTy *>(this)->getSigned()); 
 }
 
@@ -102,13 +117,16 @@ Eisdrache::VoidTy::Kind Eisdrache::VoidTy::kind() const { return VOID; }
 
 /// POINTER TY /// 
 
-Eisdrache::PtrTy::PtrTy(Eisdrache::Ptr eisdrache, Ty::Ptr pointee) {
+Eisdrache::PtrTy::PtrTy(Eisdrache::Ptr eisdrache, Ty::Ptr pointee, bool noAlias) {
     this->eisdrache = eisdrache;
     this->pointee = pointee;
+    this->noAlias = noAlias;
 }
 
 Eisdrache::Ty::Ptr &Eisdrache::PtrTy::getPointeeTy() { return pointee; }
 
+bool Eisdrache::PtrTy::isRestrict() const { return noAlias; }
+
 size_t Eisdrache::PtrTy::getBit() const { return pointee->getBit(); }
 
 Type *Eisdrache::PtrTy::getTy() const { return PointerType::get(*eisdrache->getContext(), 0); }
@@ -120,7 +138,8 @@ bool Eisdrache::PtrTy::isValidRHS(const Ty::Ptr comp) const {
 
 bool Eisdrache::PtrTy::isEqual(const Ty::Ptr comp) const {
     return comp->kind() == PTR                                                  // check wether comp is a pointer
-        && pointee->isEqual(dynamic_cast<PtrTy *>(comp.get())->getPointeeTy()); // check wether pointee type is the same
+        && pointee->isEqual(dynamic_cast<PtrTy *>(comp.get())->getPointeeTy()) // check wether pointee type is the same
+        && noAlias == dynamic_cast<PtrTy *>(comp.get())->isRestrict();
 }
 
 Eisdrache::PtrTy::Kind Eisdrache::PtrTy::kind() const { return PTR; }
@@ -183,6 +202,43 @@ bool Eisdrache::FloatTy::isEqual(const Ty::Ptr comp) const {
 
 Eisdrache::FloatTy::Kind Eisdrache::FloatTy::kind() const { return FLOAT; }
 
+/// VECTOR TY ///
+
+Eisdrache::VectorTy::VectorTy(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, size_t count, bool scalable) {
+    this->eisdrache = eisdrache;
+    this->elementTy = elementTy;
+    this->count = count;
+    this->scalable = scalable;
+}
+
+Eisdrache::Ty::Ptr Eisdrache::VectorTy::getElementTy() const { return elementTy; }
+
+const size_t &Eisdrache::VectorTy::getCount() const { return count; }
+
+const bool &Eisdrache::VectorTy::getScalable() const { return scalable; }
+
+size_t Eisdrache::VectorTy::getBit() const { return elementTy->getBit(); }
+
+Type *Eisdrache::VectorTy::getTy() const { return VectorType::get(elementTy->getTy(), count, scalable); }
+
+bool Eisdrache::VectorTy::isValidRHS(const Ty::Ptr comp) const {
+    if (comp->kind() != VECTOR)
+        return false;
+    
+    VectorTy *conv = dynamic_cast<VectorTy *>(comp.get());
+    return count == conv->count && scalable == conv->scalable && elementTy->isValidRHS(conv->elementTy);
+}
+
+bool Eisdrache::VectorTy::isEqual(const Ty::Ptr comp) const {
+    if (comp->kind() != VECTOR)
+        return false;
+    
+    VectorTy *conv = dynamic_cast<VectorTy *>(comp.get());
+    return count == conv->count && scalable == conv->scalable && elementTy->isEqual(conv->elementTy);
+}
+
+Eisdrache::VectorTy::Kind Eisdrache::VectorTy::kind() const { return VECTOR; }
+
 /// EISDRACHE REFERENCE ///
 
 Eisdrache::Reference::Reference(Eisdrache::Ptr eisdrache, std::string symbol) 
@@ -223,6 +279,7 @@ Eisdrache::Local& Eisdrache::Local::operator=(const Local &copy) {
     v_ptr = copy.v_ptr;
     type = copy.type;
     future = copy.future;
+    ssa = copy.ssa;
     eisdrache = copy.eisdrache;
     return *this;
 }
@@ -246,9 +303,13 @@ void Eisdrache::Local::setFutureArgs(ValueVec args) { future_args = args; }
 
 void Eisdrache::Local::setTy(Ty::Ptr ty) { type = ty; }
 
+void Eisdrache::Local::setSSA(int64_t variable) { ssa = variable; }
+
 AllocaInst *Eisdrache::Local::getAllocaPtr() { return operator*(); }
 
 Value *Eisdrache::Local::getValuePtr() { 
+    if (isSSA())
+        return eisdrache->readSSA(ssa, eisdrache->getBuilder()->GetInsertBlock());
     invokeFuture();
     return v_ptr; 
 }
@@ -256,23 +317,28 @@ Value *Eisdrache::Local::getValuePtr() {
 Eisdrache::Ty::Ptr Eisdrache::Local::getTy() { return type; }
 
 std::string Eisdrache::Local::getName() const { 
+    if (isSSA() && !eisdrache->ssaVariables[ssa].first.empty())
+        return eisdrache->ssaVariables[ssa].first;
     if (!v_ptr || !v_ptr->hasName())
         return "unnamed";
     return v_ptr->getName().str();
 }
 
-bool Eisdrache::Local::isAlloca() { return dyn_cast<AllocaInst>(v_ptr); }
+int64_t Eisdrache::Local::getSSA() const { return ssa; }
+
+bool Eisdrache::Local::isAlloca() { return !isSSA() && dyn_cast<AllocaInst>(v_ptr); }
+
+bool Eisdrache::Local::isSSA() const { return ssa >= 0; }
 
 Eisdrache::Local &Eisdrache::Local::loadValue(bool force, std::string name) {
     if ((!force && !isAlloca()) || !type->isPtrTy())
         return *this;
 
-    if (isAlloca())
-        invokeFuture();
-
+    Value *ptr = getValuePtr();
     Ty::Ptr loadTy = dynamic_cast<PtrTy *>(type.get())->getPointeeTy();
     LoadInst *load = eisdrache->getBuilder()->CreateLoad(loadTy->getTy(), 
-        v_ptr, name.empty() ? v_ptr->getName().str()+"_load" : name);
+        ptr, name.empty() ? getName()+"_load" : name);
+    eisdrache->annotateAccess(load, ptr);
     return eisdrache->getCurrentParent().addLocal(Local(eisdrache, loadTy, load));
 }
 
@@ -282,12 +348,12 @@ void Eisdrache::Local::invokeFuture() {
         
     if (Function *func = dyn_cast<Function>(future)) {
         if (func->getReturnType()->isVoidTy()) {
-            eisdrache->getBuilder()->CreateCall(func, future_args);
+            eisdrache->createCall(func, future_args);
             future = nullptr;
             future_args.clear();
             return;
         } else 
-            future = eisdrache->getBuilder()->CreateCall(func, future_args, getName()+"_future");
+            future = eisdrache->createCall(func, future_args, getName()+"_future");
     } 
 
     eisdrache->getBuilder()->CreateStore(future, v_ptr);
@@ -307,7 +373,8 @@ Eisdrache::Func::Func() {
     eisdrache = nullptr;
 }
 
-Eisdrache::Func::Func(Eisdrache::Ptr eisdrache, Ty::Ptr type, std::string name, Ty::Map parameters, bool entry) {
+Eisdrache::Func::Func(Eisdrache::Ptr eisdrache, Ty::Ptr type, std::string name, Ty::Map parameters, bool entry, 
+    GlobalValue::LinkageTypes linkage) {
     this->eisdrache = eisdrache;
     this->type = type;
     this->locals = Local::Map();
@@ -322,16 +389,19 @@ Eisdrache::Func::Func(Eisdrache::Ptr eisdrache, Ty::Ptr type, std::string name,
     }
 
     FunctionType *FT = FunctionType::get(type->getTy(), paramTypes, false);
-    func = Function::Create(FT, Function::ExternalLinkage, name, *eisdrache->getModule());
+    func = Function::Create(FT, linkage, name, *eisdrache->getModule());
 
     for (size_t i = 0; i < func->arg_size(); i++) {  
         func->getArg(i)->setName(paramNames[i]);
         this->parameters[i].setPtr(func->getArg(i));
+        if (PtrTy *ptr = dynamic_cast<PtrTy *>(this->parameters[i].getTy().get()); ptr && ptr->isRestrict())
+            func->getArg(i)->addAttr(Attribute::NoAlias);
     }
 
     if (entry) {
         BasicBlock *entry = BasicBlock::Create(*eisdrache->getContext(), "entry", func);
         eisdrache->setBlock(entry);
+        eisdrache->sealBlock(entry); // the entry block has no predecessors
     } else
         llvm::verifyFunction(*func);
 }
@@ -368,7 +438,9 @@ Function *Eisdrache::Func::operator*() { return func; }
 Eisdrache::Local &Eisdrache::Func::arg(size_t index) { return parameters[index]; }
 
 Eisdrache::Local &Eisdrache::Func::call(ValueVec args, std::string name) { 
-    Value *ret = eisdrache->getBuilder()->CreateCall(func, args, name); 
+    Value *ret = nullptr;
+    if (!eisdrache->builderInlining || !eisdrache->spliceCall(func, args, name, ret))
+        ret = eisdrache->createCall(func, args, name); 
     return eisdrache->getCurrentParent().addLocal(Local(eisdrache, type, ret));
 }
 
@@ -378,6 +450,63 @@ Eisdrache::Local &Eisdrache::Func::call(Local::Vec args, std::string name) {
         raw_args.push_back(local.getValuePtr());
     return this->call(raw_args, name);
 }
+
+Eisdrache::Local &Eisdrache::Func::tailCall(ValueVec args, bool mustTail, std::string name) {
+    // the callee must not access allocas or byval arguments of the caller.
+    // an uncaptured alloca can only reach the callee through the arguments,
+    // so every alloca is checked for captures and every argument is traced back
+    // through geps, casts, phis and selects to its underlying objects.
+    Function *caller = *eisdrache->getCurrentParent();
+    bool accessesStack = false;
+    for (Argument &arg : caller->args())
+        if (arg.hasByValAttr())
+            accessesStack = true;
+    for (BasicBlock &block : *caller)
+        for (Instruction &inst : block)
+            if (isa<AllocaInst>(inst) && PointerMayBeCaptured(&inst, true, true))
+                accessesStack = true;
+    for (Value *arg : args) {
+        if (accessesStack || !arg->getType()->isPointerTy())
+            continue;
+        SmallVector<const Value *, 4> objects;
+        getUnderlyingObjects(arg, objects, nullptr, 0);
+        for (const Value *object : objects)
+            if (isa<AllocaInst>(object))
+                accessesStack = true;
+    }
+
+    CallInst *inst = eisdrache->createCall(func, args, name);
+    if (!mustTail) {
+        if (!accessesStack)
+            inst->setTailCallKind(CallInst::TCK_Tail);
+        return eisdrache->getCurrentParent().addLocal(Local(eisdrache, type, inst));
+    }
+
+    if (caller->getFunctionType() != func->getFunctionType() || caller->getCallingConv() != func->getCallingConv())
+        Eisdrache::complain("Eisdrache::Func::tailCall(): Prototype or calling convention of @"+caller->getName().str()
+            +"() does not match @"+func->getName().str()+"() for a musttail call.");
+    if (accessesStack)
+        Eisdrache::complain("Eisdrache::Func::tailCall(): @"+func->getName().str()
+            +"() may access locals of @"+caller->getName().str()+"() through a musttail call.");
+    // LifetimeScope would end its lifetimes between the call and the return
+    if (!eisdrache->lifetimeScopes.empty())
+        Eisdrache::complain("Eisdrache::Func::tailCall(): A musttail call to @"+func->getName().str()
+            +"() can not be made inside of a LifetimeScope.");
+    inst->setTailCallKind(CallInst::TCK_MustTail);
+    // a musttail call has to be followed by a return of its result
+    if (inst->getType()->isVoidTy())
+        eisdrache->getBuilder()->CreateRetVoid();
+    else
+        eisdrache->getBuilder()->CreateRet(inst);
+    return eisdrache->getCurrentParent().addLocal(Local(eisdrache, type, inst));
+}
+
+Eisdrache::Local &Eisdrache::Func::tailCall(Local::Vec args, bool mustTail, std::string name) {
+    ValueVec raw_args = {};
+    for (Local &local : args)
+        raw_args.push_back(local.getValuePtr());
+    return this->tailCall(raw_args, mustTail, name);
+}
  
 Eisdrache::Local &Eisdrache::Func::addLocal(Local local) { 
     std::string symbol = "";
@@ -403,10 +532,47 @@ void Eisdrache::Func::addAttr(Attribute::AttrKind attr, int64_t index) {
         func->getArg(index)->addAttr(attr);
 }
 
-void Eisdrache::Func::setCallingConv(CallingConv::ID conv) { func->setCallingConv(conv); }
+void Eisdrache::Func::setCallingConv(CallingConv::ID conv) { eisdrache->setCallingConv(func, conv); }
+
+void Eisdrache::Func::setLinkage(GlobalValue::LinkageTypes linkage) { func->setLinkage(linkage); }
+
+void Eisdrache::Func::setVisibility(GlobalValue::VisibilityTypes visibility) { func->setVisibility(visibility); }
+
+void Eisdrache::Func::setInlinePolicy(InlinePolicy policy) {
+    func->removeFnAttr(Attribute::AlwaysInline);
+    func->removeFnAttr(Attribute::InlineHint);
+    func->removeFnAttr(Attribute::NoInline);
+    func->removeFnAttr(Attribute::Cold);
+    switch (policy) {
+        case ALWAYS_INLINE: func->addFnAttr(Attribute::AlwaysInline); break;
+        case INLINE_HINT:   func->addFnAttr(Attribute::InlineHint); break;
+        case NO_INLINE:     func->addFnAttr(Attribute::NoInline); break;
+        case COLD:          func->addFnAttr(Attribute::Cold); break;
+    }
+}
 
 void Eisdrache::Func::setDoesNotThrow() { func->setDoesNotThrow(); }
 
+#if LLVM_VERSION_MAJOR >= 16
+void Eisdrache::Func::setMemoryEffects(MemoryEffects effects) { func->setMemoryEffects(effects); }
+#endif
+
+void Eisdrache::Func::setWillReturn() { func->setWillReturn(); }
+
+void Eisdrache::Func::setNoSync() { func->setNoSync(); }
+
+void Eisdrache::Func::setNoFree() { func->setDoesNotFreeMemory(); }
+
+void Eisdrache::Func::setFastMath(FastMathFlags flags) {
+    auto toString = [](bool value) { return value ? "true" : "false"; };
+    bool unsafe = flags.allowReassoc() && flags.noSignedZeros() && flags.allowReciprocal() && flags.approxFunc();
+    func->addFnAttr("unsafe-fp-math", toString(unsafe));
+    func->addFnAttr("no-nans-fp-math", toString(flags.noNaNs()));
+    func->addFnAttr("no-infs-fp-math", toString(flags.noInfs()));
+    func->addFnAttr("no-signed-zeros-fp-math", toString(flags.noSignedZeros()));
+    func->addFnAttr("approx-func-fp-math", toString(flags.approxFunc()));
+}
+
 Eisdrache::Ty::Ptr Eisdrache::Func::getTy() { return type; }
 
 Eisdrache::Entity::Kind Eisdrache::Func::kind() const { return FUNC; }
@@ -449,15 +615,25 @@ Eisdrache::Ty::Ptr Eisdrache::Struct::operator[](size_t index) { return elements
 StructType *Eisdrache::Struct::operator*() { return type; }
 
 Eisdrache::Local &Eisdrache::Struct::allocate(std::string name) {
-    AllocaInst *alloca = eisdrache->getBuilder()->CreateAlloca(**this, nullptr, name);
+    AllocaInst *alloca = eisdrache->createAlloca(**this, name);
     return eisdrache->getCurrentParent().addLocal(Local(eisdrache, shared_from_this(), alloca));
 } 
 
-Eisdrache::Func *Eisdrache::Struct::createMemberFunc(Ty::Ptr type, std::string name, Ty::Map args) {
+Eisdrache::Func *Eisdrache::Struct::createMemberFunc(Ty::Ptr type, std::string name, Ty::Map args, 
+    GlobalValue::LinkageTypes linkage, bool validThis) {
     Ty::Map processed = {{"this", getPtrTo()}};
     for (Ty::Map::value_type &x : args)
         processed.push_back(x);
-    return &eisdrache->declareFunction(type, this->name+"_"+name, processed, true);
+    Func *member = &eisdrache->declareFunction(type, this->name+"_"+name, processed, true, linkage);
+    if (!validThis)
+        return member;
+
+    const DataLayout &layout = eisdrache->getModule()->getDataLayout();
+    LLVMContext &context = *eisdrache->getContext();
+    member->addAttr(Attribute::NonNull, 0);
+    member->addAttr(Attribute::getWithDereferenceableBytes(context, layout.getTypeAllocSize(this->type)), 0);
+    member->addAttr(Attribute::getWithAlignment(context, layout.getABITypeAlign(this->type)), 0);
+    return member;
 }
 
 Type *Eisdrache::Struct::getTy() const { return type; }
@@ -473,7 +649,7 @@ Eisdrache::Entity::Kind Eisdrache::Struct::kind() const { return STRUCT; }
 
 /// EISDRACHE ARRAY ///
 
-Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string name) {
+Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string name, size_t prefetchDistance) {
     this->eisdrache = eisdrache;
     this->name = name;
     this->elementTy = elementTy;
@@ -485,83 +661,90 @@ Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string
         eisdrache->getSizeTy(),     // i64 factor
     });
 
-    Func *malloc = nullptr;
-    if (!(malloc = eisdrache->getFunc("malloc")))
-        malloc = &eisdrache->declareFunction(eisdrache->getUnsignedPtrTy(8), "malloc", 
-            {eisdrache->getSizeTy()});
-
-    Func *free = nullptr;
-    if (!(free = eisdrache->getFunc("free")))
-        free = &eisdrache->declareFunction(eisdrache->getVoidTy(), "free",
-            {eisdrache->getUnsignedPtrTy(8)});
-
-    Func *memcpy = nullptr;
-    if (!(memcpy = eisdrache->getFunc("memcpy")))
-        memcpy = &eisdrache->declareFunction(eisdrache->getUnsignedPtrTy(8), "memcpy",
-            {eisdrache->getUnsignedPtrTy(8), 
-                eisdrache->getUnsignedPtrTy(8), 
-                eisdrache->getSizeTy()});
+    // plain declarations on targets without a C library
+    Func *malloc = &eisdrache->declareLibFunc(eisdrache->getUnsignedPtrTy(8), "malloc", {eisdrache->getSizeTy()}, true);
+    Func *free = &eisdrache->declareLibFunc(eisdrache->getVoidTy(), "free", {eisdrache->getUnsignedPtrTy(8)}, true);
 
     { // get_buffer
-    get_buffer = self->createMemberFunc(bufferTy, "get_buffer");
+    get_buffer = self->createMemberFunc(bufferTy, "get_buffer", Ty::Map(), GlobalValue::InternalLinkage, true);
+    get_buffer->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(get_buffer, ModRefInfo::Ref);
     Local &buffer = eisdrache->getElementVal(get_buffer->arg(0), 0, "buffer");
+    // null or allocated for elements
+    eisdrache->markAlign(buffer, eisdrache->getModule()->getDataLayout().getABITypeAlign(elementTy->getTy()).value());
     eisdrache->createRet(buffer);
     }
 
     { // set_buffer
     set_buffer = self->createMemberFunc(eisdrache->getVoidTy(), "set_buffer",
-        {{"buffer", bufferTy}});
+        {{"buffer", bufferTy}}, GlobalValue::InternalLinkage, true);
+    set_buffer->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(set_buffer, ModRefInfo::Mod);
     Local &buffer_ptr = eisdrache->getElementPtr(set_buffer->arg(0), 0, "buffer_ptr");
     eisdrache->storeValue(buffer_ptr, set_buffer->arg(1));
     eisdrache->createRet();
     }
 
     { // get_size
-    get_size = self->createMemberFunc(eisdrache->getSizeTy(), "get_size");
+    get_size = self->createMemberFunc(eisdrache->getSizeTy(), "get_size", Ty::Map(), GlobalValue::InternalLinkage, true);
+    get_size->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(get_size, ModRefInfo::Ref);
     Local &size = eisdrache->getElementVal(get_size->arg(0), 1, "size");
+    eisdrache->markRange(size, 0, (uint64_t) INT64_MAX + 1); // [0, INT64_MAX]
     eisdrache->createRet(size);
     }
 
     { // set_size
     set_size = self->createMemberFunc(eisdrache->getVoidTy(), "set_size",
-        {{"size", eisdrache->getSizeTy()}});
+        {{"size", eisdrache->getSizeTy()}}, GlobalValue::InternalLinkage, true);
+    set_size->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(set_size, ModRefInfo::Mod);
     Local &size_ptr = eisdrache->getElementPtr(set_size->arg(0), 1, "size_ptr");
     eisdrache->storeValue(size_ptr, set_size->arg(1));
     eisdrache->createRet();
     }
 
     { // get_max
-    get_max = self->createMemberFunc(eisdrache->getSizeTy(), "get_max");
+    get_max = self->createMemberFunc(eisdrache->getSizeTy(), "get_max", Ty::Map(), GlobalValue::InternalLinkage, true);
+    get_max->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(get_max, ModRefInfo::Ref);
     Local &max = eisdrache->getElementVal(get_max->arg(0), 2, "max");
+    eisdrache->markRange(max, 0, (uint64_t) INT64_MAX + 1); // [0, INT64_MAX]
     eisdrache->createRet(max);
     }
 
     { // set_max
     set_max = self->createMemberFunc(eisdrache->getVoidTy(), "set_max",
-        {{"max", eisdrache->getSizeTy()}});
+        {{"max", eisdrache->getSizeTy()}}, GlobalValue::InternalLinkage, true);
+    set_max->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(set_max, ModRefInfo::Mod);
     Local &max_ptr = eisdrache->getElementPtr(set_max->arg(0), 1, "max_ptr");
     eisdrache->storeValue(max_ptr, set_max->arg(1));
     eisdrache->createRet();
     }
     
     { // get_factor
-    get_factor = self->createMemberFunc(eisdrache->getSizeTy(), "get_factor");
+    get_factor = self->createMemberFunc(eisdrache->getSizeTy(), "get_factor", Ty::Map(), GlobalValue::InternalLinkage, true);
+    get_factor->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(get_factor, ModRefInfo::Ref);
     Local &factor = eisdrache->getElementVal(get_factor->arg(0), 3, "factor");
     eisdrache->createRet(factor);
     }
 
     { // set_factor
     set_factor = self->createMemberFunc(eisdrache->getVoidTy(), "set_factor",
-        {{"factor", eisdrache->getSizeTy()}});
+        {{"factor", eisdrache->getSizeTy()}}, GlobalValue::InternalLinkage, true);
+    set_factor->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(set_factor, ModRefInfo::Mod);
     Local &factor_ptr = eisdrache->getElementPtr(set_factor->arg(0), 1, "factor_ptr");
     eisdrache->storeValue(factor_ptr, set_factor->arg(1));
     eisdrache->createRet();
     }
 
     { // constructor
-    constructor = self->createMemberFunc(eisdrache->getVoidTy(), "constructor");
-    (**constructor)->setCallingConv(CallingConv::Fast);
-    (**constructor)->setDoesNotThrow();
+    constructor = self->createMemberFunc(eisdrache->getVoidTy(), "constructor", Ty::Map(), GlobalValue::InternalLinkage, true);
+    constructor->setCallingConv(CallingConv::Fast);
+    markAccessor(constructor, ModRefInfo::Mod);
     set_buffer->call({constructor->arg(0).getValuePtr(), eisdrache->getNullPtr(bufferTy)});
     set_size->call({constructor->arg(0).getValuePtr(), eisdrache->getInt(64, 0)});
     set_max->call({constructor->arg(0).getValuePtr(), eisdrache->getInt(64, 0)});
@@ -571,8 +754,8 @@ Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string
 
     { // constructor_size
     constructor_size = self->createMemberFunc(eisdrache->getVoidTy(), "constructor_size", 
-        {{"size", eisdrache->getSizeTy()}});
-    Local byteSize = Local(eisdrache, eisdrache->getInt(64, elementTy->getBit() / 8));
+        {{"size", eisdrache->getSizeTy()}}, GlobalValue::InternalLinkage, true);
+    Local byteSize = Local(eisdrache, eisdrache->getAllocSizeOf(elementTy));
     Local &bytes = eisdrache->binaryOp(MUL, constructor_size->arg(1), byteSize, "bytes");
     set_buffer->call({constructor_size->arg(0), malloc->call({bytes}, "buffer")});
     set_size->call({constructor_size->arg(0), constructor_size->arg(1)});
@@ -583,13 +766,13 @@ Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string
 
     { // constructor_copy
     constructor_copy = self->createMemberFunc(eisdrache->getVoidTy(), "constructor_copy", 
-        {{"original", self->getPtrTo()}});
+        {{"original", self->getPtrTo()}}, GlobalValue::InternalLinkage, true);
     // TODO: implement copy constructor
     eisdrache->createRet();
     }
 
     { // destructor
-    destructor = self->createMemberFunc(eisdrache->getVoidTy(), "destructor");
+    destructor = self->createMemberFunc(eisdrache->getVoidTy(), "destructor", Ty::Map(), GlobalValue::InternalLinkage, true);
     destructor->setCallingConv(CallingConv::Fast);
     destructor->setDoesNotThrow();
     BasicBlock *free_begin = eisdrache->createBlock("free_begin");
@@ -606,12 +789,12 @@ Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string
 
     { // resize
     resize = self->createMemberFunc(eisdrache->getVoidTy(), "resize",
-        {{"new_size", eisdrache->getSizeTy()}});
+        {{"new_size", eisdrache->getSizeTy()}}, GlobalValue::InternalLinkage, true);
     BasicBlock *copy = eisdrache->createBlock("copy");
     BasicBlock *empty = eisdrache->createBlock("empty");
     BasicBlock *end = eisdrache->createBlock("end"); 
     
-    Local byteSize = Local(eisdrache, eisdrache->getInt(64, elementTy->getBit() / 8));
+    Local byteSize = Local(eisdrache, eisdrache->getAllocSizeOf(elementTy));
     Local &bytes = eisdrache->binaryOp(MUL, resize->arg(1), byteSize, "bytes");
     Local &new_buffer = malloc->call({bytes}, "new_buffer");
     Local &buffer = get_buffer->call({resize->arg(0)}, "buffer");
@@ -619,7 +802,8 @@ Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string
     eisdrache->jump(eisdrache->compareToNull(buffer, "cond"), empty, copy);
     
     eisdrache->setBlock(copy);
-    memcpy->call({new_buffer, buffer, size});
+    Local &size_bytes = eisdrache->binaryOp(MUL, size, byteSize, "size_bytes");
+    eisdrache->memCopy(new_buffer, buffer, size_bytes);
     free->call({buffer});
     eisdrache->jump(end);
 
@@ -636,26 +820,42 @@ Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string
 
     { // is_valid_index
     is_valid_index = self->createMemberFunc(eisdrache->getBoolTy(), "is_valid_index",
-        {{"index", eisdrache->getSizeTy()}});
+        {{"index", eisdrache->getSizeTy()}}, GlobalValue::InternalLinkage, true);
+    is_valid_index->setInlinePolicy(Func::ALWAYS_INLINE);
+    markAccessor(is_valid_index, ModRefInfo::Ref);
     Local &max = get_max->call({is_valid_index->arg(0)}, "max");
     eisdrache->createRet(eisdrache->binaryOp(LES, is_valid_index->arg(1), max, "equals"));
     }
 
+    // indices passed to the accessors are required to be valid
+    WrapScope inBounds = WrapScope(eisdrache);
+
     { // get_at_index
     get_at_index = self->createMemberFunc(elementTy, "get_at_index", 
-        {{"index", eisdrache->getUnsignedTy(32)}});
+        {{"index", eisdrache->getUnsignedTy(32)}}, GlobalValue::InternalLinkage, true);
+    get_at_index->setInlinePolicy(Func::ALWAYS_INLINE);
+    // reads `this` and the buffer, llvm.prefetch is modeled as access to inaccessible memory
+    markAccessor(get_at_index, ModRefInfo::Ref, ModRefInfo::Ref, prefetchDistance);
     Local &buffer = get_buffer->call({get_at_index->arg(0)}, "buffer");
     Local &element_ptr = eisdrache->getArrayElement(buffer, get_at_index->arg(1), "element_ptr");
+    if (prefetchDistance) {
+        // may point past the end of the buffer, so this GEP is not inbounds
+        Value *ahead = eisdrache->getBuilder()->CreateGEP(elementTy->getTy(), element_ptr.getValuePtr(), 
+            {eisdrache->getInt(64, prefetchDistance)}, "prefetch_ptr");
+        Local prefetch_ptr = Local(eisdrache, bufferTy, ahead);
+        eisdrache->prefetch(prefetch_ptr);
+    }
     eisdrache->createRet(element_ptr.loadValue(true, "element"));
     }
 
     { // set_at_index
     set_at_index = self->createMemberFunc(eisdrache->getVoidTy(), "set_at_index",
-        {{"index", eisdrache->getUnsignedTy(32)}, {"value", elementTy}});
+        {{"index", eisdrache->getUnsignedTy(32)}, {"value", elementTy}}, GlobalValue::InternalLinkage, true);
+    set_at_index->setInlinePolicy(Func::ALWAYS_INLINE);
+    // reads `this`, writes the buffer
+    markAccessor(set_at_index, ModRefInfo::Ref, ModRefInfo::Mod);
     Local &buffer = get_buffer->call({set_at_index->arg(0)}, "buffer");
-    Value *raw_ptr = eisdrache->getBuilder()->CreateGEP(bufferTy->getTy(), buffer.getValuePtr(), 
-        {set_at_index->arg(1).getValuePtr()}, "element_ptr");
-    Local element_ptr = Local(eisdrache, bufferTy, raw_ptr);
+    Local &element_ptr = eisdrache->getArrayElement(buffer, set_at_index->arg(1), "element_ptr");
     eisdrache->storeValue(element_ptr, set_at_index->arg(2));
     eisdrache->createRet();
     }
@@ -663,6 +863,28 @@ Eisdrache::Array::Array(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, std::string
 
 Eisdrache::Array::~Array() { name.clear(); }
 
+void Eisdrache::Array::markAccessor(Func *member, ModRefInfo argMem, ModRefInfo otherMem, bool prefetches) {
+#if LLVM_VERSION_MAJOR >= 16
+    MemoryEffects effects = MemoryEffects::argMemOnly(argMem) | MemoryEffects(MemoryEffects::Other, otherMem);
+    if (prefetches)
+        effects |= MemoryEffects::inaccessibleMemOnly();
+    member->setMemoryEffects(effects);
+#else
+    // approximate with the attributes of older versions, llvm.prefetch modifies inaccessible memory
+    Function *func = **member;
+    if (!prefetches && isNoModRef(otherMem))
+        func->setOnlyAccessesArgMemory();
+    if (!prefetches && !isModSet(argMem) && !isModSet(otherMem))
+        func->setOnlyReadsMemory();
+    else if (!prefetches && !isRefSet(argMem) && !isRefSet(otherMem))
+        func->setOnlyWritesMemory();
+#endif
+    member->setDoesNotThrow();
+    member->setWillReturn();
+    member->setNoSync();
+    member->setNoFree();
+}
+
 Eisdrache::Local &Eisdrache::Array::allocate(std::string name) {
     return eisdrache->allocateStruct(self, name);
 }
@@ -699,6 +921,196 @@ Eisdrache::Local &Eisdrache::Array::call(Member callee, Local::Vec args, std::st
     return call(callee, raw_args, name);
 }
 
+/// EISDRACHE LOOP ///
+
+Eisdrache::Loop::Loop(Eisdrache::Ptr eisdrache, Local &begin, Local &end, std::string name) 
+: Loop(eisdrache, begin, end, Hints(), name) {}
+
+Eisdrache::Loop::Loop(Eisdrache::Ptr eisdrache, Local &begin, Local &end, Hints hints, std::string name) {
+    this->eisdrache = eisdrache;
+    this->name = name;
+    this->hints = hints;
+
+    Local &from = begin.loadValue();
+    Local &to = end.loadValue();
+    if (to.getTy()->kind() != Entity::INT || from.getValuePtr()->getType() != to.getValuePtr()->getType())
+        Eisdrache::complain("Eisdrache::Loop::Loop(): Bounds of loop have to be integers of the same type.");
+
+    BasicBlock *preheader = eisdrache->createBlock(name+"_preheader");
+    header = eisdrache->createBlock(name+"_header");
+    BasicBlock *body = eisdrache->createBlock(name+"_body");
+    latch = eisdrache->createBlock(name+"_latch");
+    exit = eisdrache->createBlock(name+"_exit");
+
+    Value *first = from.getValuePtr();
+    eisdrache->jump(preheader);
+    eisdrache->setBlock(preheader);
+    eisdrache->sealBlock(preheader);
+    eisdrache->jump(header);
+
+    eisdrache->setBlock(header);
+    phi = eisdrache->getBuilder()->CreatePHI(to.getTy()->getTy(), 2, name+"_index");
+    phi->addIncoming(first, preheader);
+    index = &eisdrache->getCurrentParent().addLocal(Local(eisdrache, to.getTy(), phi));
+    eisdrache->jump(eisdrache->binaryOp(LES, *index, to, name+"_cond"), body, exit);
+
+    eisdrache->setBlock(body);
+    eisdrache->sealBlock(body);
+}
+
+Eisdrache::Local &Eisdrache::Loop::getIndex() { return *index; }
+
+BasicBlock *Eisdrache::Loop::getLatch() { return latch; }
+
+BasicBlock *Eisdrache::Loop::getExit() { return exit; }
+
+void Eisdrache::Loop::close() {
+    eisdrache->jump(latch);
+    eisdrache->setBlock(latch);
+    eisdrache->sealBlock(latch);
+
+    // index < end, so the increment can not wrap
+    bool isSigned = index->getTy()->isSignedTy();
+    Value *next = eisdrache->getBuilder()->CreateAdd(phi, ConstantInt::get(phi->getType(), 1), 
+        name+"_next", !isSigned, isSigned);
+    phi->addIncoming(next, latch);
+    BranchInst *backedge = eisdrache->jump(header);
+    backedge->setMetadata(LLVMContext::MD_loop, createMetadata());
+    eisdrache->sealBlock(header);
+
+    eisdrache->setBlock(exit);
+    eisdrache->sealBlock(exit);
+}
+
+MDNode *Eisdrache::Loop::createMetadata() {
+    LLVMContext &context = *eisdrache->getContext();
+    std::vector<Metadata *> operands = {nullptr}; // reserved for self reference
+
+    if (hints.mustProgress)
+        operands.push_back(MDNode::get(context, MDString::get(context, "llvm.loop.mustprogress")));
+    if (hints.vectorize)
+        operands.push_back(MDNode::get(context, {MDString::get(context, "llvm.loop.vectorize.enable"), 
+            ConstantAsMetadata::get(eisdrache->getBool(true))}));
+    if (hints.vectorizeWidth)
+        operands.push_back(MDNode::get(context, {MDString::get(context, "llvm.loop.vectorize.width"), 
+            ConstantAsMetadata::get(eisdrache->getInt(32, hints.vectorizeWidth))}));
+    if (hints.interleaveCount)
+        operands.push_back(MDNode::get(context, {MDString::get(context, "llvm.loop.interleave.count"), 
+            ConstantAsMetadata::get(eisdrache->getInt(32, hints.interleaveCount))}));
+    if (hints.unrollCount)
+        operands.push_back(MDNode::get(context, {MDString::get(context, "llvm.loop.unroll.count"), 
+            ConstantAsMetadata::get(eisdrache->getInt(32, hints.unrollCount))}));
+    if (hints.unrollFull)
+        operands.push_back(MDNode::get(context, MDString::get(context, "llvm.loop.unroll.full")));
+
+    MDNode *loopID = MDNode::getDistinct(context, operands);
+    loopID->replaceOperandWith(0, loopID);
+    return loopID;
+}
+
+/// EISDRACHE LIFETIME SCOPE ///
+
+Eisdrache::LifetimeScope::LifetimeScope(Eisdrache::Ptr eisdrache) : eisdrache(eisdrache) {
+    BasicBlock *block = eisdrache->getBuilder()->GetInsertBlock();
+    function = block ? block->getParent() : nullptr;
+    eisdrache->lifetimeScopes.push_back(this);
+}
+
+Eisdrache::LifetimeScope::~LifetimeScope() {
+    BasicBlock *block = eisdrache->getBuilder()->GetInsertBlock();
+    if (!allocas.empty() && (!block || block->getParent() != function))
+        Eisdrache::complain("Eisdrache::LifetimeScope::~LifetimeScope(): Scope ends outside of @"
+            +function->getName().str()+"().");
+    IRBuilder<> endBuilder(block);
+    // end lifetimes before the terminator if the block was closed already
+    if (Instruction *terminator = block->getTerminator())
+        endBuilder.SetInsertPoint(terminator);
+    
+    const DataLayout &layout = eisdrache->getModule()->getDataLayout();
+    for (auto alloca = allocas.rbegin(); alloca != allocas.rend(); alloca++) {
+        uint64_t size = layout.getTypeAllocSize((*alloca)->getAllocatedType());
+        endBuilder.CreateLifetimeEnd(*alloca, eisdrache->getInt(64, size));
+    }
+
+    allocas.clear();
+    eisdrache->lifetimeScopes.pop_back();
+}
+
+bool Eisdrache::LifetimeScope::add(AllocaInst *alloca) {
+    if (alloca->getFunction() != function)
+        return false;
+
+    uint64_t size = eisdrache->getModule()->getDataLayout().getTypeAllocSize(alloca->getAllocatedType());
+    eisdrache->getBuilder()->CreateLifetimeStart(alloca, eisdrache->getInt(64, size));
+    allocas.push_back(alloca);
+    return true;
+}
+
+/// EISDRACHE WRAP SCOPE ///
+
+Eisdrache::WrapScope::WrapScope(Eisdrache::Ptr eisdrache) : WrapScope(eisdrache, Flags()) {}
+
+Eisdrache::WrapScope::WrapScope(Eisdrache::Ptr eisdrache, Flags flags) : flags(flags), eisdrache(eisdrache) {
+    eisdrache->wrapScopes.push_back(this);
+}
+
+Eisdrache::WrapScope::~WrapScope() { eisdrache->wrapScopes.pop_back(); }
+
+const Eisdrache::WrapScope::Flags &Eisdrache::WrapScope::getFlags() const { return flags; }
+
+/// EISDRACHE FAST MATH SCOPE ///
+
+Eisdrache::FastMathScope::FastMathScope(Eisdrache::Ptr eisdrache) 
+: FastMathScope(eisdrache, FastMathFlags::getFast()) {}
+
+Eisdrache::FastMathScope::FastMathScope(Eisdrache::Ptr eisdrache, FastMathFlags flags) 
+: guard(*eisdrache->getBuilder()) {
+    eisdrache->getBuilder()->setFastMathFlags(flags);
+}
+
+Eisdrache::FastMathScope::~FastMathScope() {} // guard restores the previous flags
+
+/// EISDRACHE ALIAS SCOPE ///
+
+Eisdrache::AliasScope::AliasScope(Eisdrache::Ptr eisdrache, std::vector<Local *> bases, std::string name) 
+: eisdrache(eisdrache) {
+    MDBuilder md = MDBuilder(*eisdrache->getContext());
+    MDNode *domain = md.createAnonymousAliasScopeDomain(name);
+    for (Local *base : bases) {
+        if (!base->getTy()->isPtrTy())
+            Eisdrache::complain("Eisdrache::AliasScope::AliasScope(): Base is not a pointer (%"+base->getName()+").");
+        
+        const Value *object = getUnderlyingObject(base->getValuePtr());
+        for (std::pair<const Value *, Metadata *> &scope : scopes)
+            if (scope.first == object)
+                Eisdrache::complain("Eisdrache::AliasScope::AliasScope(): Bases have the same underlying object (%"+base->getName()+").");
+        scopes.push_back({object, md.createAnonymousAliasScope(domain, name+"."+base->getName())});
+    }
+    eisdrache->aliasScopes.push_back(this);
+}
+
+Eisdrache::AliasScope::~AliasScope() { 
+    scopes.clear();
+    eisdrache->aliasScopes.pop_back(); 
+}
+
+void Eisdrache::AliasScope::annotate(Instruction *inst, Value *ptr) {
+    const Value *object = getUnderlyingObject(ptr);
+    std::vector<Metadata *> own = {};
+    std::vector<Metadata *> others = {};
+    for (std::pair<const Value *, Metadata *> &scope : scopes)
+        (scope.first == object ? own : others).push_back(scope.second);
+    if (own.empty())
+        return;
+
+    LLVMContext &context = *eisdrache->getContext();
+    inst->setMetadata(LLVMContext::MD_alias_scope, 
+        MDNode::concatenate(inst->getMetadata(LLVMContext::MD_alias_scope), MDNode::get(context, own)));
+    if (!others.empty())
+        inst->setMetadata(LLVMContext::MD_noalias, 
+            MDNode::concatenate(inst->getMetadata(LLVMContext::MD_noalias), MDNode::get(context, others)));
+}
+
 /// EISDRACHE WRAPPER ///
 
 Eisdrache::~Eisdrache() {
@@ -758,6 +1170,12 @@ Eisdrache::Ty::Ptr Eisdrache::getFloatPtrTy(size_t bit) { return addTy(std::make
 
 Eisdrache::Ty::Ptr Eisdrache::getFloatPtrPtrTy(size_t bit) { return addTy(std::make_shared<PtrTy>(shared_from_this(), getFloatPtrTy(bit))); };
 
+Eisdrache::Ty::Ptr Eisdrache::getRestrictPtrTy(Ty::Ptr pointee) { return addTy(std::make_shared<PtrTy>(shared_from_this(), pointee, true)); }
+
+Eisdrache::Ty::Ptr Eisdrache::getVectorTy(Ty::Ptr elementTy, size_t count, bool scalable) { 
+    return addTy(std::make_shared<VectorTy>(shared_from_this(), elementTy, count, scalable)); 
+}
+
 /// VALUES ///
 
 ConstantInt *Eisdrache::getBool(bool value) { return builder->getInt1(value); }
@@ -774,6 +1192,45 @@ Constant *Eisdrache::getLiteral(std::string value, std::string name) { return bu
 
 ConstantPointerNull *Eisdrache::getNullPtr(Ty::Ptr ptrTy) { return ConstantPointerNull::get(dyn_cast<PointerType>(ptrTy->getTy())); }
 
+uint64_t Eisdrache::sizeOf(Ty::Ptr type) {
+    if (!type->getTy()->isSized())
+        complain("Eisdrache::sizeOf(): Type has no size.");
+    TypeSize size = module->getDataLayout().getTypeStoreSize(type->getTy());
+    if (size.isScalable())
+        complain("Eisdrache::sizeOf(): Size of scalable vectors is not known at compile time.");
+    return size.getFixedValue();
+}
+
+uint64_t Eisdrache::allocSizeOf(Ty::Ptr type) {
+    if (!type->getTy()->isSized())
+        complain("Eisdrache::allocSizeOf(): Type has no size.");
+    TypeSize size = module->getDataLayout().getTypeAllocSize(type->getTy());
+    if (size.isScalable())
+        complain("Eisdrache::allocSizeOf(): Size of scalable vectors is not known at compile time.");
+    return size.getFixedValue();
+}
+
+uint64_t Eisdrache::alignOf(Ty::Ptr type) {
+    if (!type->getTy()->isSized())
+        complain("Eisdrache::alignOf(): Type has no alignment.");
+    return module->getDataLayout().getABITypeAlign(type->getTy()).value();
+}
+
+uint64_t Eisdrache::offsetOf(Struct::Ptr type, size_t index) {
+    StructType *structTy = **type;
+    if (index >= structTy->getNumElements())
+        complain("Eisdrache::offsetOf(): Index "+std::to_string(index)+" is out of range.");
+    return module->getDataLayout().getStructLayout(structTy)->getElementOffset(index);
+}
+
+ConstantInt *Eisdrache::getSizeOf(Ty::Ptr type) { return getInt(64, sizeOf(type)); }
+
+ConstantInt *Eisdrache::getAllocSizeOf(Ty::Ptr type) { return getInt(64, allocSizeOf(type)); }
+
+ConstantInt *Eisdrache::getAlignOf(Ty::Ptr type) { return getInt(64, alignOf(type)); }
+
+ConstantInt *Eisdrache::getOffsetOf(Struct::Ptr type, size_t index) { return getInt(64, offsetOf(type, index)); }
+
 /// FUNCTIONS ///
 
 Eisdrache::Func &Eisdrache::declareFunction(Ty::Ptr type, std::string name, Ty::Vec parameters) {   
@@ -785,12 +1242,40 @@ Eisdrache::Func &Eisdrache::declareFunction(Ty::Ptr type, std::string name, Ty::
     return *parent;
 }
 
-Eisdrache::Func &Eisdrache::declareFunction(Ty::Ptr type, std::string name, Ty::Map parameters, bool entry) {
-    functions[name] = Func(shared_from_this(), type, name, parameters, entry);
+Eisdrache::Func &Eisdrache::declareFunction(Ty::Ptr type, std::string name, Ty::Map parameters, bool entry, 
+    GlobalValue::LinkageTypes linkage) {
+    if (!entry && linkage != GlobalValue::ExternalLinkage && linkage != GlobalValue::ExternalWeakLinkage)
+        complain("Eisdrache::declareFunction(): Declaration of @"+name+"() has to have external linkage.");
+    functions[name] = Func(shared_from_this(), type, name, parameters, entry, linkage);
     parent = &functions.at(name);
     return *parent;
 }
 
+Eisdrache::Func &Eisdrache::declareLibFunc(Ty::Ptr type, std::string name, Ty::Vec parameters, bool fallback) {
+    Func *wrap = getFunc(name);
+    if (!wrap) {
+        Func *previous = parent;
+        wrap = &declareFunction(type, name, parameters);
+        parent = previous;
+    }
+    
+    TargetLibraryInfoImpl impl = TargetLibraryInfoImpl(Triple(module->getTargetTriple()));
+    TargetLibraryInfo info = TargetLibraryInfo(impl);
+    LibFunc libFunc;
+    // also checks the prototype
+    if (!info.getLibFunc(***wrap, libFunc) || !info.has(libFunc)) {
+        if (fallback)
+            return *wrap;
+        complain("Eisdrache::declareLibFunc(): @"+name+"() is not a library function of the target or has a different prototype.");
+    }
+#if LLVM_VERSION_MAJOR >= 15
+    inferNonMandatoryLibFuncAttrs(***wrap, info);
+#else
+    inferLibFuncAttributes(***wrap, info);
+#endif
+    return *wrap;
+}
+
 Eisdrache::Func &Eisdrache::getWrap(Function *function) {
     for (Func::Map::value_type &wrap : functions)
         if (wrap.second == function)
@@ -800,9 +1285,80 @@ Eisdrache::Func &Eisdrache::getWrap(Function *function) {
 }
 
 bool Eisdrache::verifyFunc(Func &wrap) { 
+    for (BasicBlock &block : **wrap)
+        sealBlock(&block);
     return llvm::verifyFunction(**wrap); 
 }
 
+Eisdrache::InternalizeStats Eisdrache::internalize(std::set<std::string> keep) {
+    InternalizeStats stats = InternalizeStats();
+    for (Function &func : *module) {
+        stats.instructionsBefore += func.getInstructionCount();
+        if (!func.isDeclaration() && func.hasExternalLinkage() && !keep.contains(func.getName().str())) {
+            func.setLinkage(GlobalValue::InternalLinkage);
+            stats.internalized++;
+        }
+    }
+
+    // removing a function can make its callees unused
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (Function &func : make_early_inc_range(*module)) {
+            if (!(func.hasLocalLinkage() || func.hasLinkOnceLinkage()) || !func.use_empty())
+                continue;
+            
+            std::string name = func.getName().str();
+            if (parent && **parent == &func)
+                parent = nullptr;
+            functions.erase(name);
+            func.eraseFromParent();
+            stats.removed++;
+            changed = true;
+        }
+    }
+
+    for (Function &func : *module)
+        stats.instructionsAfter += func.getInstructionCount();
+    return stats;
+}
+
+size_t Eisdrache::useFastCallingConv(std::set<std::string> group) {
+    std::set<Function *> candidates = {};
+    for (Function &func : *module)
+        if (!func.isDeclaration() && func.hasLocalLinkage() && !func.hasAddressTaken() && !func.isVarArg()
+            && (group.empty() || group.contains(func.getName().str())))
+            candidates.insert(&func);
+
+    auto convOf = [&candidates](Function *func) { 
+        return candidates.contains(func) ? CallingConv::ID(CallingConv::Fast) : func->getCallingConv(); 
+    };
+
+    // caller and callee of a musttail call have to agree on the convention
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (Function &func : *module)
+            for (User *user : func.users()) {
+                CallInst *call = dyn_cast<CallInst>(user);
+                if (!call || !call->isMustTailCall() || call->getCalledFunction() != &func)
+                    continue;
+                Function *caller = call->getFunction();
+                if (convOf(caller) != convOf(&func)) {
+                    candidates.erase(caller);
+                    candidates.erase(&func);
+                    changed = true;
+                }
+            }
+    }
+
+    size_t switched = 0;
+    for (Function *func : candidates)
+        if (func->getCallingConv() != CallingConv::Fast) {
+            setCallingConv(func, CallingConv::Fast);
+            switched++;
+        }
+    return switched;
+}
+
 Eisdrache::Local &Eisdrache::callFunction(Func &wrap, ValueVec args, std::string name) { 
     return wrap.call(args, name);
 }
@@ -822,24 +1378,271 @@ Eisdrache::Local &Eisdrache::callFunction(std::string callee, Local::Vec args, s
 /// LOCALS ///
 
 Eisdrache::Local &Eisdrache::declareLocal(Ty::Ptr type, std::string name, Value *value, ValueVec future_args) {
-    AllocaInst *alloca = builder->CreateAlloca(type->getTy(), nullptr, name);
+    AllocaInst *alloca = createAlloca(type->getTy(), name);
     return parent->addLocal(Local(shared_from_this(), type->getPtrTo(), alloca, value, future_args));
 }
 
+Eisdrache::Local &Eisdrache::declareSSA(Ty::Ptr type, std::string name, Value *value) {
+    Local local = Local(shared_from_this(), type);
+    local.setSSA(ssaVariables.size());
+    ssaVariables.push_back({name, type->getTy()});
+    if (value)
+        writeSSA(local.getSSA(), builder->GetInsertBlock(), value);
+    return parent->addLocal(local);
+}
+
+void Eisdrache::assignSSA(Local &variable, Local &value) {
+    if (!variable.isSSA())
+        complain("Eisdrache::assignSSA(): Local is not a SSA variable (%"+variable.getName()+").");
+    
+    Value *v = value.loadValue().getValuePtr();
+    if (v->getType() != variable.getTy()->getTy())
+        complain("Eisdrache::assignSSA(): Type of value differs from type of variable (%"+variable.getName()+").");
+
+    writeSSA(variable.getSSA(), builder->GetInsertBlock(), v);
+}
+
+void Eisdrache::assignSSA(Local &variable, Constant *value) {
+    if (!variable.isSSA())
+        complain("Eisdrache::assignSSA(): Local is not a SSA variable (%"+variable.getName()+").");
+    
+    if (value->getType() != variable.getTy()->getTy())
+        complain("Eisdrache::assignSSA(): Type of value differs from type of variable (%"+variable.getName()+").");
+
+    writeSSA(variable.getSSA(), builder->GetInsertBlock(), value);
+}
+
+void Eisdrache::sealBlock(BasicBlock *block) {
+    if (sealedBlocks.count(block))
+        return;
+    
+    sealedBlocks[block] = true;
+    std::vector<std::pair<int64_t, WeakVH>> phis = incompletePhis[block];
+    incompletePhis.erase(block);
+    for (std::pair<int64_t, WeakVH> &phi : phis)
+        if (PHINode *node = dyn_cast_or_null<PHINode>(phi.second))
+            addPhiOperands(phi.first, node);
+}
+
 Eisdrache::Local &Eisdrache::loadLocal(Local &local, std::string name) { return local.loadValue(); }
 
-StoreInst *Eisdrache::storeValue(Local &local, Local &value) {
+StoreInst *Eisdrache::storeValue(Local &local, Local &value, bool nonTemporal) {
     if (!local.getTy()->isPtrTy())
         return Eisdrache::complain("Eisdrache::storeValue(): Local is not a pointer (%"+local.getName()+").");
     
-    return builder->CreateStore(value.getValuePtr(), local.getValuePtr());
+    StoreInst *store = builder->CreateStore(value.getValuePtr(), local.getValuePtr());
+    annotateAccess(store, local.getValuePtr());
+    if (nonTemporal)
+        store->setMetadata(LLVMContext::MD_nontemporal, MDNode::get(*context, ConstantAsMetadata::get(getInt(32, 1))));
+    return store;
 } 
 
-StoreInst *Eisdrache::storeValue(Local &local, Constant *value) {
+StoreInst *Eisdrache::storeValue(Local &local, Constant *value, bool nonTemporal) {
     if (!local.getTy()->isPtrTy())
         return Eisdrache::complain("Eisdrache::storeValue(): Local is not a pointer.");
     
-    return builder->CreateStore(value, local.getValuePtr());
+    StoreInst *store = builder->CreateStore(value, local.getValuePtr());
+    annotateAccess(store, local.getValuePtr());
+    if (nonTemporal)
+        store->setMetadata(LLVMContext::MD_nontemporal, MDNode::get(*context, ConstantAsMetadata::get(getInt(32, 1))));
+    return store;
+}
+
+Eisdrache::Local &Eisdrache::atomicLoad(Local &ptr, AtomicOrdering ordering, SyncScope::ID scope, std::string name) {
+    Align align = getAtomicAlign(ptr, "Eisdrache::atomicLoad()");
+    if (ordering == AtomicOrdering::Release || ordering == AtomicOrdering::AcquireRelease)
+        complain("Eisdrache::atomicLoad(): Loads can not have release semantics (%"+ptr.getName()+").");
+    
+    Ty::Ptr loadTy = dynamic_cast<PtrTy *>(ptr.getTy().get())->getPointeeTy();
+    LoadInst *load = builder->CreateAlignedLoad(loadTy->getTy(), ptr.getValuePtr(), align, 
+        name.empty() ? ptr.getName()+"_load" : name);
+    load->setAtomic(ordering, scope);
+    annotateAccess(load, ptr.getValuePtr());
+    return parent->addLocal(Local(shared_from_this(), loadTy, load));
+}
+
+StoreInst *Eisdrache::atomicStore(Local &ptr, Local &value, AtomicOrdering ordering, SyncScope::ID scope) {
+    Align align = getAtomicAlign(ptr, "Eisdrache::atomicStore()");
+    if (ordering == AtomicOrdering::Acquire || ordering == AtomicOrdering::AcquireRelease)
+        return complain("Eisdrache::atomicStore(): Stores can not have acquire semantics (%"+ptr.getName()+").");
+    
+    Value *v = value.loadValue().getValuePtr();
+    if (v->getType() != dynamic_cast<PtrTy *>(ptr.getTy().get())->getPointeeTy()->getTy())
+        return complain("Eisdrache::atomicStore(): Value has a different type than the pointee (%"+value.getName()+").");
+
+    StoreInst *store = builder->CreateAlignedStore(v, ptr.getValuePtr(), align);
+    store->setAtomic(ordering, scope);
+    annotateAccess(store, ptr.getValuePtr());
+    return store;
+}
+
+Eisdrache::Local &Eisdrache::atomicOp(Op op, Local &ptr, Local &value, AtomicOrdering ordering, SyncScope::ID scope, std::string name) {
+    Align align = getAtomicAlign(ptr, "Eisdrache::atomicOp()");
+    Local &v = value.loadValue();
+    Ty::Ptr ty = dynamic_cast<PtrTy *>(ptr.getTy().get())->getPointeeTy();
+    if (v.getValuePtr()->getType() != ty->getTy())
+        complain("Eisdrache::atomicOp(): Value has a different type than the pointee (%"+value.getName()+").");
+
+    bool isFloat = ty->isFloatTy();
+    if (!isFloat && !ty->isIntTy())
+        complain("Eisdrache::atomicOp(): Pointee is not a number (%"+ptr.getName()+").");
+    
+    AtomicRMWInst::BinOp binOp;
+    switch (op) {
+        case ADD:   binOp = isFloat ? AtomicRMWInst::FAdd : AtomicRMWInst::Add; break;
+        case SUB:   binOp = isFloat ? AtomicRMWInst::FSub : AtomicRMWInst::Sub; break;
+        case AND:   binOp = AtomicRMWInst::And; break;
+        case OR:    binOp = AtomicRMWInst::Or; break;
+        case XOR:   binOp = AtomicRMWInst::Xor; break;
+        case MIN:
+        case MAX:
+            if (!isFloat) {
+                if (op == MIN)
+                    binOp = ty->isSignedTy() ? AtomicRMWInst::Min : AtomicRMWInst::UMin;
+                else
+                    binOp = ty->isSignedTy() ? AtomicRMWInst::Max : AtomicRMWInst::UMax;
+                break;
+            }
+#if LLVM_VERSION_MAJOR >= 15
+            binOp = op == MIN ? AtomicRMWInst::FMin : AtomicRMWInst::FMax;
+            break;
+#else
+            complain("Eisdrache::atomicOp(): Floating point minimum and maximum require LLVM 15 or newer (%"+ptr.getName()+").");
+            return value; // silence warning
+#endif
+        default:
+            complain("Eisdrache::atomicOp(): Operation (ID "+std::to_string(op)+") has no atomic variant.");
+            return value; // silence warning
+    }
+    if (isFloat && (op == AND || op == OR || op == XOR))
+        complain("Eisdrache::atomicOp(): Bitwise operations require integers (%"+ptr.getName()+").");
+
+    AtomicRMWInst *rmw = builder->CreateAtomicRMW(binOp, ptr.getValuePtr(), v.getValuePtr(), align, ordering, scope);
+    rmw->setName(name.empty() ? "atomictmp" : name);
+    annotateAccess(rmw, ptr.getValuePtr());
+    return parent->addLocal(Local(shared_from_this(), ty, rmw));
+}
+
+Eisdrache::Local &Eisdrache::atomicExchange(Local &ptr, Local &value, AtomicOrdering ordering, SyncScope::ID scope, std::string name) {
+    Align align = getAtomicAlign(ptr, "Eisdrache::atomicExchange()");
+    Local &v = value.loadValue();
+    Ty::Ptr ty = dynamic_cast<PtrTy *>(ptr.getTy().get())->getPointeeTy();
+    if (v.getValuePtr()->getType() != ty->getTy())
+        complain("Eisdrache::atomicExchange(): Value has a different type than the pointee (%"+value.getName()+").");
+
+    AtomicRMWInst *rmw = builder->CreateAtomicRMW(AtomicRMWInst::Xchg, ptr.getValuePtr(), v.getValuePtr(), align, ordering, scope);
+    rmw->setName(name.empty() ? "xchgtmp" : name);
+    annotateAccess(rmw, ptr.getValuePtr());
+    return parent->addLocal(Local(shared_from_this(), ty, rmw));
+}
+
+Eisdrache::Local &Eisdrache::compareExchange(Local &ptr, Local &expected, Local &desired, 
+    AtomicOrdering success, AtomicOrdering failure, bool weak, SyncScope::ID scope, std::string name) {
+    Align align = getAtomicAlign(ptr, "Eisdrache::compareExchange()");
+    Ty::Ptr ty = dynamic_cast<PtrTy *>(ptr.getTy().get())->getPointeeTy();
+    if (!expected.getTy()->isPtrTy() || dynamic_cast<PtrTy *>(expected.getTy().get())->getPointeeTy()->getTy() != ty->getTy())
+        complain("Eisdrache::compareExchange(): Expected value has to be a pointer to the same type (%"+expected.getName()+").");
+    if (!AtomicCmpXchgInst::isValidSuccessOrdering(success))
+        complain("Eisdrache::compareExchange(): Success ordering has to be at least monotonic (%"+ptr.getName()+").");
+    if (!AtomicCmpXchgInst::isValidFailureOrdering(failure))
+        complain("Eisdrache::compareExchange(): Invalid failure ordering (%"+ptr.getName()+").");
+    
+    Local &d = desired.loadValue();
+    if (d.getValuePtr()->getType() != ty->getTy())
+        complain("Eisdrache::compareExchange(): Desired value has a different type than the pointee (%"+desired.getName()+").");
+
+    if (name.empty()) name = "cmpxchgtmp";
+    Value *e = builder->CreateLoad(ty->getTy(), expected.getValuePtr(), name+"_expected");
+    AtomicCmpXchgInst *cmpxchg = builder->CreateAtomicCmpXchg(ptr.getValuePtr(), e, d.getValuePtr(), align, 
+        success, failure, scope);
+    cmpxchg->setWeak(weak);
+    cmpxchg->setName(name+"_pair");
+    annotateAccess(cmpxchg, ptr.getValuePtr());
+
+    // on success the value read equals the expected one, so it can be written back unconditionally
+    builder->CreateStore(builder->CreateExtractValue(cmpxchg, 0, name+"_actual"), expected.getValuePtr());
+    Value *exchanged = builder->CreateExtractValue(cmpxchg, 1, name);
+    return parent->addLocal(Local(shared_from_this(), getBoolTy(), exchanged));
+}
+
+FenceInst *Eisdrache::fence(AtomicOrdering ordering, SyncScope::ID scope) {
+    if (ordering != AtomicOrdering::Acquire && ordering != AtomicOrdering::Release
+        && ordering != AtomicOrdering::AcquireRelease && ordering != AtomicOrdering::SequentiallyConsistent)
+        return complain("Eisdrache::fence(): Fences require acquire or release semantics.");
+    return builder->CreateFence(ordering, scope);
+}
+
+CallInst *Eisdrache::prefetch(Local &ptr, bool write, unsigned locality) {
+    if (!ptr.getTy()->isPtrTy())
+        return complain("Eisdrache::prefetch(): Local is not a pointer (%"+ptr.getName()+").");
+    if (locality > 3)
+        return complain("Eisdrache::prefetch(): Locality has to be between 0 and 3.");
+    
+    // rw, locality, cache type (1: data)
+    return builder->CreateIntrinsic(Intrinsic::prefetch, {ptr.getValuePtr()->getType()}, 
+        {ptr.getValuePtr(), getInt(32, write), getInt(32, locality), getInt(32, 1)});
+}
+
+CallInst *Eisdrache::memCopy(Local &dest, Local &src, Local &bytes, bool isVolatile) {
+    MaybeAlign destAlign = getPointeeAlign(dest, "Eisdrache::memCopy()");
+    MaybeAlign srcAlign = getPointeeAlign(src, "Eisdrache::memCopy()");
+    return builder->CreateMemCpy(dest.getValuePtr(), destAlign, src.getValuePtr(), srcAlign, 
+        loadBytes(bytes, "Eisdrache::memCopy()"), isVolatile);
+}
+
+CallInst *Eisdrache::memMove(Local &dest, Local &src, Local &bytes, bool isVolatile) {
+    MaybeAlign destAlign = getPointeeAlign(dest, "Eisdrache::memMove()");
+    MaybeAlign srcAlign = getPointeeAlign(src, "Eisdrache::memMove()");
+    return builder->CreateMemMove(dest.getValuePtr(), destAlign, src.getValuePtr(), srcAlign, 
+        loadBytes(bytes, "Eisdrache::memMove()"), isVolatile);
+}
+
+CallInst *Eisdrache::memSet(Local &dest, Local &value, Local &bytes, bool isVolatile) {
+    MaybeAlign align = getPointeeAlign(dest, "Eisdrache::memSet()");
+    Value *byte = value.loadValue().getValuePtr();
+    if (!byte->getType()->isIntegerTy(8))
+        return complain("Eisdrache::memSet(): Value is not a byte (%"+value.getName()+").");
+    return builder->CreateMemSet(dest.getValuePtr(), byte, loadBytes(bytes, "Eisdrache::memSet()"), align, isVolatile);
+}
+
+void Eisdrache::markNonNull(Local &load) {
+    LoadInst *inst = getLoadInst(load, "Eisdrache::markNonNull()");
+    if (!inst->getType()->isPointerTy())
+        complain("Eisdrache::markNonNull(): Loaded value is not a pointer (%"+load.getName()+").");
+    inst->setMetadata(LLVMContext::MD_nonnull, MDNode::get(*context, {}));
+}
+
+void Eisdrache::markDereferenceable(Local &load, uint64_t bytes, bool orNull) {
+    LoadInst *inst = getLoadInst(load, "Eisdrache::markDereferenceable()");
+    if (!inst->getType()->isPointerTy())
+        complain("Eisdrache::markDereferenceable(): Loaded value is not a pointer (%"+load.getName()+").");
+    inst->setMetadata(orNull ? LLVMContext::MD_dereferenceable_or_null : LLVMContext::MD_dereferenceable, 
+        MDNode::get(*context, ConstantAsMetadata::get(getInt(64, bytes))));
+}
+
+void Eisdrache::markAlign(Local &load, uint64_t align) {
+    LoadInst *inst = getLoadInst(load, "Eisdrache::markAlign()");
+    if (!inst->getType()->isPointerTy() || !isPowerOf2_64(align))
+        complain("Eisdrache::markAlign(): Loaded value is not a pointer or alignment is not a power of two (%"+load.getName()+").");
+    inst->setMetadata(LLVMContext::MD_align, MDNode::get(*context, ConstantAsMetadata::get(getInt(64, align))));
+}
+
+void Eisdrache::markRange(Local &load, uint64_t low, uint64_t high) {
+    LoadInst *inst = getLoadInst(load, "Eisdrache::markRange()");
+    IntegerType *type = dyn_cast<IntegerType>(inst->getType());
+    if (!type)
+        complain("Eisdrache::markRange(): Loaded value is not an integer (%"+load.getName()+").");
+    
+    APInt l = APInt(type->getBitWidth(), low);
+    APInt h = APInt(type->getBitWidth(), high);
+    if (l == h)
+        complain("Eisdrache::markRange(): Range is empty (%"+load.getName()+").");
+    inst->setMetadata(LLVMContext::MD_range, MDBuilder(*context).createRange(l, h));
+}
+
+void Eisdrache::markInvariant(Local &load) {
+    LoadInst *inst = getLoadInst(load, "Eisdrache::markInvariant()");
+    inst->setMetadata(LLVMContext::MD_invariant_load, MDNode::get(*context, {}));
 }
 
 void Eisdrache::createFuture(Local &local, Value *value) { local.setFuture(value); }
@@ -857,13 +1660,13 @@ Eisdrache::Struct::Ptr &Eisdrache::declareStruct(std::string name, Ty::Vec eleme
 }
 
 Eisdrache::Local &Eisdrache::allocateStruct(Struct::Ptr wrap, std::string name) {
-    AllocaInst *alloca = builder->CreateAlloca(**wrap, nullptr, name);
+    AllocaInst *alloca = createAlloca(**wrap, name);
     return parent->addLocal(Local(shared_from_this(), wrap, alloca));
 }
 
 Eisdrache::Local &Eisdrache::allocateStruct(std::string typeName, std::string name) {
     Struct::Ptr &ref = structs.at(typeName);
-    AllocaInst *alloca = builder->CreateAlloca(**ref, nullptr, name);
+    AllocaInst *alloca = createAlloca(**ref, name);
     return parent->addLocal(Local(shared_from_this(), ref->getPtrTo(), alloca));
 }
 
@@ -877,7 +1680,8 @@ Eisdrache::Local &Eisdrache::getElementPtr(Local &parent, size_t index, std::str
         complain("Eisdrache::getElementPtr(): Type of parent is not a pointer to a struct.");
     
     Struct &ref = *dynamic_cast<Struct *>(ptr->getPointeeTy().get());
-    Value *gep = builder->CreateGEP(*ref, parent.getValuePtr(), 
+    // a field of a valid struct pointer is always in bounds
+    Value *gep = builder->CreateInBoundsGEP(*ref, parent.getValuePtr(), 
         {getInt(32, 0), getInt(32, index)}, name);
     return this->parent->addLocal(Local(shared_from_this(), ref[index]->getPtrTo(), gep));
 }
@@ -929,41 +1733,45 @@ Eisdrache::Local &Eisdrache::binaryOp(Op op, Local &LHS, Local &RHS, std::string
     if (!ty->isValidRHS(r.getTy()))
         Eisdrache::complain("Eisdrache::binaryOp(): LHS and RHS types differ too much.");
 
+    WrapScope::Flags wrap = getWrapFlags();
     switch (op) {
         case ADD:
             if (name.empty()) name = "addtmp";
             if (ty->isFloatTy()) 
                 bop.setPtr(builder->CreateFAdd(l.getValuePtr(), r.getValuePtr(), name));
             else
-                bop.setPtr(builder->CreateAdd(l.getValuePtr(), r.getValuePtr(), name));
+                bop.setPtr(builder->CreateAdd(l.getValuePtr(), r.getValuePtr(), name, 
+                    !ty->isSignedTy() && wrap.noUnsignedWrap, ty->isSignedTy() && wrap.noSignedWrap));
             break;
         case SUB:
             if (name.empty()) name = "subtmp";
             if (ty->isFloatTy())
                 bop.setPtr(builder->CreateFSub(l.getValuePtr(), r.getValuePtr(), name));
             else 
-                bop.setPtr(builder->CreateSub(l.getValuePtr(), r.getValuePtr(), name));
+                bop.setPtr(builder->CreateSub(l.getValuePtr(), r.getValuePtr(), name, 
+                    !ty->isSignedTy() && wrap.noUnsignedWrap, ty->isSignedTy() && wrap.noSignedWrap));
             break;
         case MUL:
             if (name.empty()) name = "multmp";
             if (ty->isFloatTy())
                 bop.setPtr(builder->CreateFMul(l.getValuePtr(), r.getValuePtr(), name));
             else
-                bop.setPtr(builder->CreateMul(l.getValuePtr(), r.getValuePtr(), name));
+                bop.setPtr(builder->CreateMul(l.getValuePtr(), r.getValuePtr(), name, 
+                    !ty->isSignedTy() && wrap.noUnsignedWrap, ty->isSignedTy() && wrap.noSignedWrap));
             break;
         case DIV:
             if (name.empty()) name = "divtmp";
-            bop.setPtr(builder->CreateFDiv(l.getValuePtr(), r.getValuePtr(), name));
-            bop.setTy(getFloatTy(64));
+            if (ty->isFloatTy())
+                bop.setPtr(builder->CreateFDiv(l.getValuePtr(), r.getValuePtr(), name));
+            else
+                bop.setPtr(createDivision(l.getValuePtr(), r.getValuePtr(), ty->isSignedTy(), false, false, name));
             break;
         case MOD:
             if (name.empty()) name = "modtmp";
             if (ty->isFloatTy())
                 bop.setPtr(builder->CreateFRem(l.getValuePtr(), r.getValuePtr(), name));
-            else if (ty->isSignedTy())
-                bop.setPtr(builder->CreateSRem(l.getValuePtr(), r.getValuePtr(), name));
             else
-                bop.setPtr(builder->CreateURem(l.getValuePtr(), r.getValuePtr(), name));
+                bop.setPtr(createDivision(l.getValuePtr(), r.getValuePtr(), ty->isSignedTy(), true, false, name));
             break;
         case OR:    
             bop.setPtr(builder->CreateOr(l.getValuePtr(), r.getValuePtr(), name.empty() ? "ortmp" : name)); 
@@ -975,11 +1783,30 @@ Eisdrache::Local &Eisdrache::binaryOp(Op op, Local &LHS, Local &RHS, std::string
             bop.setPtr(builder->CreateAnd(l.getValuePtr(), r.getValuePtr(), name.empty() ? "andtmp" : name)); 
             break;
         case LSH:   
-            bop.setPtr(builder->CreateShl(l.getValuePtr(), r.getValuePtr(), name.empty() ? "lshtmp" : name)); 
+            bop.setPtr(builder->CreateShl(l.getValuePtr(), r.getValuePtr(), name.empty() ? "lshtmp" : name, 
+                !ty->isSignedTy() && wrap.noUnsignedWrap, ty->isSignedTy() && wrap.noSignedWrap)); 
             break;
         case RSH:   
             bop.setPtr(builder->CreateLShr(l.getValuePtr(), r.getValuePtr(), name.empty() ? "rshtmp" : name)); 
             break;
+        case MIN:
+            if (name.empty()) name = "mintmp";
+            if (ty->isFloatTy())
+                bop.setPtr(builder->CreateMinNum(l.getValuePtr(), r.getValuePtr(), name));
+            else if (ty->isSignedTy())
+                bop.setPtr(builder->CreateBinaryIntrinsic(Intrinsic::smin, l.getValuePtr(), r.getValuePtr(), nullptr, name));
+            else
+                bop.setPtr(builder->CreateBinaryIntrinsic(Intrinsic::umin, l.getValuePtr(), r.getValuePtr(), nullptr, name));
+            break;
+        case MAX:
+            if (name.empty()) name = "maxtmp";
+            if (ty->isFloatTy())
+                bop.setPtr(builder->CreateMaxNum(l.getValuePtr(), r.getValuePtr(), name));
+            else if (ty->isSignedTy())
+                bop.setPtr(builder->CreateBinaryIntrinsic(Intrinsic::smax, l.getValuePtr(), r.getValuePtr(), nullptr, name));
+            else
+                bop.setPtr(builder->CreateBinaryIntrinsic(Intrinsic::umax, l.getValuePtr(), r.getValuePtr(), nullptr, name));
+            break;
         case EQU:
             if (name.empty()) name = "equtmp";
             if (ty->isFloatTy())
@@ -1037,6 +1864,18 @@ Eisdrache::Local &Eisdrache::binaryOp(Op op, Local &LHS, Local &RHS, std::string
     return parent->addLocal(bop);
 }
 
+Eisdrache::Local &Eisdrache::exactDiv(Local &LHS, Local &RHS, std::string name) {
+    Local &l = LHS.loadValue(false, LHS.getName()+"_lhs_load");
+    Local &r = RHS.loadValue(false, RHS.getName()+"_rhs_load");
+    Ty::Ptr ty = l.getTy();
+    if (!ty->isIntTy() || !ty->isValidRHS(r.getTy()))
+        complain("Eisdrache::exactDiv(): LHS and RHS have to be integers of the same type.");
+
+    Value *div = createDivision(l.getValuePtr(), r.getValuePtr(), ty->isSignedTy(), false, true, 
+        name.empty() ? "divtmp" : name);
+    return parent->addLocal(Local(shared_from_this(), ty, div));
+}
+
 Eisdrache::Local &Eisdrache::bitCast(Local &ptr, Ty::Ptr to, std::string name) {
     Value *cast = builder->CreateBitCast(ptr.getValuePtr(), to->getTy(), name);
     return parent->addLocal(Local(shared_from_this(), to, cast));
@@ -1050,6 +1889,120 @@ BranchInst *Eisdrache::jump(Local &condition, BasicBlock *then, BasicBlock *else
     return builder->CreateCondBr(condition.loadValue().getValuePtr(), then, else_);
 }
 
+BranchInst *Eisdrache::jump(Local &condition, BasicBlock *then, BasicBlock *else_, Branch likely) {
+    // default weights of the llvm.expect lowering
+    if (likely == LIKELY)
+        return jump(condition, then, else_, 2000, 1);
+    return jump(condition, then, else_, 1, 2000);
+}
+
+BranchInst *Eisdrache::jump(Local &condition, BasicBlock *then, BasicBlock *else_, uint32_t thenWeight, uint32_t elseWeight) {
+    MDNode *weights = MDBuilder(*context).createBranchWeights(thenWeight, elseWeight);
+    return builder->CreateCondBr(condition.loadValue().getValuePtr(), then, else_, weights);
+}
+
+Eisdrache::Local &Eisdrache::expect(Local &value, Constant *expected, std::string name) {
+    Local &load = value.loadValue();
+    if (!load.getTy()->isIntTy() || expected->getType() != load.getValuePtr()->getType())
+        complain("Eisdrache::expect(): Expected value has to be an integer of the same type (%"+value.getName()+").");
+    
+    Value *result = builder->CreateIntrinsic(Intrinsic::expect, {expected->getType()}, 
+        {load.getValuePtr(), expected}, nullptr, name.empty() ? "expecttmp" : name);
+    return parent->addLocal(Local(shared_from_this(), load.getTy(), result));
+}
+
+SwitchInst *Eisdrache::createSwitch(Local &condition, BasicBlock *default_, 
+    std::vector<std::pair<ConstantInt *, BasicBlock *>> cases, std::vector<uint32_t> weights) {
+    if (!weights.empty() && weights.size() != cases.size() + 1)
+        return complain("Eisdrache::createSwitch(): Expected "+std::to_string(cases.size() + 1)+" weights (default and cases).");
+    
+    SwitchInst *inst = builder->CreateSwitch(condition.loadValue().getValuePtr(), default_, cases.size());
+    for (std::pair<ConstantInt *, BasicBlock *> &c : cases)
+        inst->addCase(c.first, c.second);
+    
+    if (!weights.empty())
+        inst->setMetadata(LLVMContext::MD_prof, MDBuilder(*context).createBranchWeights(weights));
+    return inst;
+}
+
+Eisdrache::Local &Eisdrache::createLookup(Local &condition, std::vector<std::pair<ConstantInt *, Constant *>> cases, 
+    Constant *default_, std::string name) {
+    if (name.empty()) name = "lookuptmp";
+    Local &load = condition.loadValue();
+    Value *v = load.getValuePtr();
+    IntegerType *conditionTy = dyn_cast<IntegerType>(v->getType());
+    if (!conditionTy)
+        complain("Eisdrache::createLookup(): Condition is not an integer (%"+condition.getName()+").");
+    // constants are unique, so equal values of the same type are the same pointer
+    std::set<ConstantInt *> values = {};
+    for (std::pair<ConstantInt *, Constant *> &c : cases) {
+        if (c.first->getType() != conditionTy)
+            complain("Eisdrache::createLookup(): Case value "+toString(c.first->getValue(), 10, false)
+                +" has a different type than the condition (%"+condition.getName()+").");
+        if (!values.insert(c.first).second)
+            complain("Eisdrache::createLookup(): Duplicate case value "+toString(c.first->getValue(), 10, false)+".");
+        if (c.second->getType() != default_->getType())
+            complain("Eisdrache::createLookup(): Types of the results differ.");
+    }
+
+    Ty::Ptr resultTy = Ty::create(shared_from_this(), default_->getType());
+    if (cases.empty())
+        return parent->addLocal(Local(shared_from_this(), resultTy, default_));
+
+    // range of the case values
+    bool isSigned = load.getTy()->isSignedTy();
+    APInt low = cases.front().first->getValue();
+    APInt high = low;
+    for (std::pair<ConstantInt *, Constant *> &c : cases) {
+        const APInt &value = c.first->getValue();
+        if (isSigned ? value.slt(low) : value.ult(low)) low = value;
+        if (isSigned ? value.sgt(high) : value.ugt(high)) high = value;
+    }
+    APInt range = high - low;
+    uint64_t size = range.ult(4096) ? range.getZExtValue() + 1 : 0;
+
+    // like SimplifyCFG, use a table if at least 40% of its entries are cases
+    if (size && cases.size() * 10 >= size * 4 && isUIntN(conditionTy->getBitWidth(), size)) {
+        std::vector<Constant *> entries = std::vector<Constant *>(size, default_);
+        for (std::pair<ConstantInt *, Constant *> &c : cases)
+            entries[(c.first->getValue() - low).getZExtValue()] = c.second;
+
+        ArrayType *tableTy = ArrayType::get(default_->getType(), size);
+        GlobalVariable *table = new GlobalVariable(*module, tableTy, true, GlobalValue::PrivateLinkage, 
+            ConstantArray::get(tableTy, entries), name+"_table");
+        table->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+
+        Value *index = builder->CreateSub(v, ConstantInt::get(conditionTy, low), name+"_index");
+        Value *inRange = builder->CreateICmpULT(index, ConstantInt::get(conditionTy, size), name+"_in_range");
+        // never load out of bounds, even if the result is not used
+        Value *safe = builder->CreateSelect(inRange, index, ConstantInt::get(conditionTy, 0), name+"_safe_index");
+        safe = builder->CreateZExt(safe, builder->getInt64Ty());
+        Value *element = builder->CreateInBoundsGEP(tableTy, table, {getInt(64, 0), safe}, name+"_ptr");
+        Value *entry = builder->CreateLoad(default_->getType(), element, name+"_entry");
+        Value *result = builder->CreateSelect(inRange, entry, default_, name);
+        return parent->addLocal(Local(shared_from_this(), resultTy, result));
+    }
+    
+    BasicBlock *current = builder->GetInsertBlock();
+    BasicBlock *join = createBlock(name+"_join");
+    SwitchInst *inst = builder->CreateSwitch(v, join, cases.size());
+    std::vector<std::pair<BasicBlock *, Constant *>> incoming = {{current, default_}};
+    for (std::pair<ConstantInt *, Constant *> &c : cases) {
+        BasicBlock *block = createBlock(name+"_case", true);
+        sealBlock(block);
+        inst->addCase(c.first, block);
+        jump(join);
+        incoming.push_back({block, c.second});
+    }
+
+    setBlock(join);
+    sealBlock(join);
+    PHINode *phi = builder->CreatePHI(default_->getType(), incoming.size(), name);
+    for (std::pair<BasicBlock *, Constant *> &i : incoming)
+        phi->addIncoming(i.second, i.first);
+    return parent->addLocal(Local(shared_from_this(), resultTy, phi));
+}
+
 Eisdrache::Local &Eisdrache::typeCast(Local &value, Ty::Ptr to, std::string name) {
     if (value.getTy()->isEqual(to))
         return value.loadValue();
@@ -1058,6 +2011,14 @@ Eisdrache::Local &Eisdrache::typeCast(Local &value, Ty::Ptr to, std::string name
     Value *v = load.getValuePtr();
     Ty::Ptr from = load.getTy();
     Local &cast = parent->addLocal(Local(shared_from_this(), to));
+
+    if (from->isVectorTy() || to->isVectorTy()) {
+        VectorTy *fromVector = dynamic_cast<VectorTy *>(from.get());
+        VectorTy *toVector = dynamic_cast<VectorTy *>(to.get());
+        if (!fromVector || !toVector 
+        || fromVector->getCount() != toVector->getCount() || fromVector->getScalable() != toVector->getScalable())
+            complain("Eisdrache::typeCast(): Invalid type cast (Vectors need the same amount of elements).");
+    }
     
     if (from->isFloatTy()) {
         if (to->isFloatTy()) {                                                      // FLOAT -> FLOAT
@@ -1111,13 +2072,25 @@ Eisdrache::Local &Eisdrache::typeCast(Local &value, Ty::Ptr to, std::string name
 }
 
 Eisdrache::Local &Eisdrache::getArrayElement(Local &array, size_t index, std::string name) {
-    Value *ptr = builder->CreateGEP(array.getTy()->getTy(), array.getValuePtr(),
-        {getInt(32, index)}, name);
-    return parent->addLocal(Local(shared_from_this(), array.getTy(), ptr));
+    Local constant = Local(shared_from_this(), getSizeTy(), getInt(64, index));
+    return getArrayElement(array, constant, name);
 }
 
 Eisdrache::Local &Eisdrache::getArrayElement(Local &array, Eisdrache::Local &index, std::string name) {
-    Value *ptr = builder->CreateGEP(array.getTy()->getTy(), array.getValuePtr(), {index.getValuePtr()}, name);
+    PtrTy *arrayTy = dynamic_cast<PtrTy *>(array.getTy().get());
+    if (!arrayTy)
+        complain("Eisdrache::getArrayElement(): Array is not a pointer (%"+array.getName()+").");
+    
+    // void * is indexed bytewise
+    Type *elementTy = arrayTy->getPointeeTy()->kind() == Entity::VOID 
+        ? builder->getInt8Ty() : arrayTy->getPointeeTy()->getTy();
+    Value *ptr = getWrapFlags().inBounds
+        ? builder->CreateInBoundsGEP(elementTy, array.getValuePtr(), {index.getValuePtr()}, name)
+        : builder->CreateGEP(elementTy, array.getValuePtr(), {index.getValuePtr()}, name);
+    // a vector of indices results in a vector of pointers
+    if (VectorTy *indexTy = dynamic_cast<VectorTy *>(index.getTy().get()))
+        return parent->addLocal(Local(shared_from_this(), 
+            getVectorTy(array.getTy(), indexTy->getCount(), indexTy->getScalable()), ptr));
     return parent->addLocal(Local(shared_from_this(), array.getTy(), ptr));
 }
 
@@ -1153,6 +2126,305 @@ Eisdrache::Local &Eisdrache::unaryOp(Op op, Local &expr, std::string name) {
     return parent->addLocal(ret);
 } 
 
+Eisdrache::Local &Eisdrache::select(Local &condition, Local &then, Local &else_, std::string name) {
+    Local &t = then.loadValue();
+    Local &e = else_.loadValue();
+    if (t.getValuePtr()->getType() != e.getValuePtr()->getType())
+        complain("Eisdrache::select(): Types of the values differ (%"+then.getName()+", %"+else_.getName()+").");
+    
+    Value *select = builder->CreateSelect(condition.loadValue().getValuePtr(), t.getValuePtr(), e.getValuePtr(), 
+        name.empty() ? "selecttmp" : name);
+    return parent->addLocal(Local(shared_from_this(), t.getTy(), select));
+}
+
+Eisdrache::Local &Eisdrache::min(Local &LHS, Local &RHS, std::string name) { return binaryOp(MIN, LHS, RHS, name); }
+
+Eisdrache::Local &Eisdrache::max(Local &LHS, Local &RHS, std::string name) { return binaryOp(MAX, LHS, RHS, name); }
+
+Eisdrache::Local &Eisdrache::abs(Local &expr, std::string name) {
+    Local &load = expr.loadValue();
+    Ty::Ptr ty = load.getTy();
+    if (name.empty()) name = "abstmp";
+
+    if (ty->isFloatTy()) {
+        Value *abs = builder->CreateUnaryIntrinsic(Intrinsic::fabs, load.getValuePtr(), nullptr, name);
+        return parent->addLocal(Local(shared_from_this(), ty, abs));
+    } else if (ty->isSignedTy()) {
+        // INT_MIN stays INT_MIN instead of being poison
+        Value *abs = builder->CreateBinaryIntrinsic(Intrinsic::abs, load.getValuePtr(), getBool(false), nullptr, name);
+        return parent->addLocal(Local(shared_from_this(), ty, abs));
+    } else if (ty->isIntTy())
+        return load;
+    
+    complain("Eisdrache::abs(): Local is not a number (%"+expr.getName()+").");
+    return load; // silence warning
+}
+
+Eisdrache::Local &Eisdrache::clamp(Local &value, Local &low, Local &high, std::string name) {
+    Local &lowered = max(value, low, value.getName()+"_low");
+    return min(lowered, high, name.empty() ? "clamptmp" : name);
+}
+
+Eisdrache::Local &Eisdrache::popCount(Local &expr, std::string name) {
+    return createIntrinsic(Intrinsic::ctpop, {&expr}, false, "Eisdrache::popCount()", name.empty() ? "popcnt" : name);
+}
+
+Eisdrache::Local &Eisdrache::countLeadingZeros(Local &expr, bool zeroIsPoison, std::string name) {
+    Local &load = expr.loadValue();
+    if (!load.getTy()->isIntTy())
+        complain("Eisdrache::countLeadingZeros(): Local is not an integer (%"+expr.getName()+").");
+    Value *ctlz = builder->CreateBinaryIntrinsic(Intrinsic::ctlz, load.getValuePtr(), getBool(zeroIsPoison), 
+        nullptr, name.empty() ? "ctlz" : name);
+    return parent->addLocal(Local(shared_from_this(), load.getTy(), ctlz));
+}
+
+Eisdrache::Local &Eisdrache::countTrailingZeros(Local &expr, bool zeroIsPoison, std::string name) {
+    Local &load = expr.loadValue();
+    if (!load.getTy()->isIntTy())
+        complain("Eisdrache::countTrailingZeros(): Local is not an integer (%"+expr.getName()+").");
+    Value *cttz = builder->CreateBinaryIntrinsic(Intrinsic::cttz, load.getValuePtr(), getBool(zeroIsPoison), 
+        nullptr, name.empty() ? "cttz" : name);
+    return parent->addLocal(Local(shared_from_this(), load.getTy(), cttz));
+}
+
+Eisdrache::Local &Eisdrache::byteSwap(Local &expr, std::string name) {
+    Local &load = expr.loadValue();
+    if (!load.getTy()->isIntTy() || load.getTy()->getBit() % 16 != 0)
+        complain("Eisdrache::byteSwap(): Bit width is not a multiple of 16 (%"+expr.getName()+").");
+    return createIntrinsic(Intrinsic::bswap, {&load}, false, "Eisdrache::byteSwap()", name.empty() ? "bswap" : name);
+}
+
+Eisdrache::Local &Eisdrache::funnelShiftLeft(Local &high, Local &low, Local &amount, std::string name) {
+    return createIntrinsic(Intrinsic::fshl, {&high, &low, &amount}, false, 
+        "Eisdrache::funnelShiftLeft()", name.empty() ? "fshl" : name);
+}
+
+Eisdrache::Local &Eisdrache::funnelShiftRight(Local &high, Local &low, Local &amount, std::string name) {
+    return createIntrinsic(Intrinsic::fshr, {&high, &low, &amount}, false, 
+        "Eisdrache::funnelShiftRight()", name.empty() ? "fshr" : name);
+}
+
+Eisdrache::Local &Eisdrache::fma(Local &a, Local &b, Local &c, std::string name) {
+    return createIntrinsic(Intrinsic::fma, {&a, &b, &c}, true, "Eisdrache::fma()", name.empty() ? "fma" : name);
+}
+
+Eisdrache::Local &Eisdrache::fmulAdd(Local &a, Local &b, Local &c, std::string name) {
+    return createIntrinsic(Intrinsic::fmuladd, {&a, &b, &c}, true, "Eisdrache::fmulAdd()", name.empty() ? "fmuladd" : name);
+}
+
+Eisdrache::Local &Eisdrache::sqrt(Local &expr, std::string name) {
+    return createIntrinsic(Intrinsic::sqrt, {&expr}, true, "Eisdrache::sqrt()", name.empty() ? "sqrt" : name);
+}
+
+Eisdrache::Local &Eisdrache::saturatingOp(Op op, Local &LHS, Local &RHS, std::string name) {
+    Local &l = LHS.loadValue();
+    Local &r = RHS.loadValue();
+    if (!l.getTy()->isIntTy() || l.getValuePtr()->getType() != r.getValuePtr()->getType())
+        complain("Eisdrache::saturatingOp(): Operands have to be integers of the same type (%"+LHS.getName()+").");
+
+    bool isSigned = l.getTy()->isSignedTy();
+    Intrinsic::ID id;
+    switch (op) {
+        case ADD:   id = isSigned ? Intrinsic::sadd_sat : Intrinsic::uadd_sat; break;
+        case SUB:   id = isSigned ? Intrinsic::ssub_sat : Intrinsic::usub_sat; break;
+        case LSH:   id = isSigned ? Intrinsic::sshl_sat : Intrinsic::ushl_sat; break;
+        default:
+            complain("Eisdrache::saturatingOp(): Operation (ID "+std::to_string(op)+") has no saturating variant.");
+            return LHS; // silence warning
+    }
+    return createIntrinsic(id, {&l, &r}, false, "Eisdrache::saturatingOp()", name.empty() ? "sattmp" : name);
+}
+
+Eisdrache::Local &Eisdrache::checkedOp(Op op, Local &LHS, Local &RHS, BasicBlock *overflow, std::string name) {
+    Local &l = LHS.loadValue();
+    Local &r = RHS.loadValue();
+    // the overflow flag branches, so vectors are not supported
+    if (l.getTy()->kind() != Entity::INT || l.getValuePtr()->getType() != r.getValuePtr()->getType())
+        complain("Eisdrache::checkedOp(): Operands have to be scalar integers of the same type (%"+LHS.getName()+").");
+    
+    bool isSigned = l.getTy()->isSignedTy();
+    Intrinsic::ID id;
+    switch (op) {
+        case ADD:   id = isSigned ? Intrinsic::sadd_with_overflow : Intrinsic::uadd_with_overflow; break;
+        case SUB:   id = isSigned ? Intrinsic::ssub_with_overflow : Intrinsic::usub_with_overflow; break;
+        case MUL:   id = isSigned ? Intrinsic::smul_with_overflow : Intrinsic::umul_with_overflow; break;
+        default:
+            complain("Eisdrache::checkedOp(): Operation (ID "+std::to_string(op)+") has no checked variant.");
+            return LHS; // silence warning
+    }
+
+    if (name.empty()) name = "checkedtmp";
+    Value *pair = builder->CreateBinaryIntrinsic(id, l.getValuePtr(), r.getValuePtr(), nullptr, name+"_pair");
+    Value *result = builder->CreateExtractValue(pair, 0, name);
+    Local overflowed = Local(shared_from_this(), getBoolTy(), builder->CreateExtractValue(pair, 1, name+"_overflow"));
+
+    BasicBlock *next = createBlock(name+"_ok");
+    jump(overflowed, overflow, next, UNLIKELY);
+    setBlock(next);
+    sealBlock(next);
+    return parent->addLocal(Local(shared_from_this(), l.getTy(), result));
+}
+
+Eisdrache::Local &Eisdrache::splat(Local &value, size_t count, bool scalable, std::string name) {
+    Local &load = value.loadValue();
+    Value *vector = builder->CreateVectorSplat(ElementCount::get(count, scalable), load.getValuePtr(), 
+        name.empty() ? "splattmp" : name);
+    return parent->addLocal(Local(shared_from_this(), getVectorTy(load.getTy(), count, scalable), vector));
+}
+
+Eisdrache::Local &Eisdrache::insertElement(Local &vector, Local &value, size_t index, std::string name) {
+    Local constant = Local(shared_from_this(), getInt(64, index));
+    return insertElement(vector, value, constant, name);
+}
+
+Eisdrache::Local &Eisdrache::insertElement(Local &vector, Local &value, Local &index, std::string name) {
+    Local &load = vector.loadValue();
+    VectorTy *vectorTy = dynamic_cast<VectorTy *>(load.getTy().get());
+    if (!vectorTy)
+        complain("Eisdrache::insertElement(): Local is not a vector (%"+vector.getName()+").");
+    Local &element = value.loadValue();
+    if (element.getValuePtr()->getType() != vectorTy->getElementTy()->getTy())
+        complain("Eisdrache::insertElement(): Value has a different type than the elements (%"+value.getName()+").");
+    Local &i = index.loadValue();
+    if (i.getTy()->kind() != Entity::INT)
+        complain("Eisdrache::insertElement(): Index is not an integer (%"+index.getName()+").");
+    
+    Value *insert = builder->CreateInsertElement(load.getValuePtr(), element.getValuePtr(), 
+        i.getValuePtr(), name.empty() ? "inserttmp" : name);
+    return parent->addLocal(Local(shared_from_this(), load.getTy(), insert));
+}
+
+Eisdrache::Local &Eisdrache::extractElement(Local &vector, size_t index, std::string name) {
+    Local constant = Local(shared_from_this(), getInt(64, index));
+    return extractElement(vector, constant, name);
+}
+
+Eisdrache::Local &Eisdrache::extractElement(Local &vector, Local &index, std::string name) {
+    Local &load = vector.loadValue();
+    VectorTy *vectorTy = dynamic_cast<VectorTy *>(load.getTy().get());
+    if (!vectorTy)
+        complain("Eisdrache::extractElement(): Local is not a vector (%"+vector.getName()+").");
+    Local &i = index.loadValue();
+    if (i.getTy()->kind() != Entity::INT)
+        complain("Eisdrache::extractElement(): Index is not an integer (%"+index.getName()+").");
+    
+    Value *extract = builder->CreateExtractElement(load.getValuePtr(), i.getValuePtr(), 
+        name.empty() ? "extracttmp" : name);
+    return parent->addLocal(Local(shared_from_this(), vectorTy->getElementTy(), extract));
+}
+
+Eisdrache::Local &Eisdrache::shuffleVector(Local &first, Local &second, std::vector<int> mask, std::string name) {
+    Local &l = first.loadValue();
+    Local &r = second.loadValue();
+    VectorTy *vectorTy = dynamic_cast<VectorTy *>(l.getTy().get());
+    if (!vectorTy || !l.getTy()->isEqual(r.getTy()))
+        complain("Eisdrache::shuffleVector(): Locals have to be vectors of the same type.");
+    if (vectorTy->getScalable())
+        complain("Eisdrache::shuffleVector(): Can not shuffle scalable vectors.");
+    
+    Value *shuffle = builder->CreateShuffleVector(l.getValuePtr(), r.getValuePtr(), mask, 
+        name.empty() ? "shuffletmp" : name);
+    return parent->addLocal(Local(shared_from_this(), getVectorTy(vectorTy->getElementTy(), mask.size()), shuffle));
+}
+
+Eisdrache::Local &Eisdrache::reduce(Op op, Local &vector, bool ordered, std::string name) {
+    Local &load = vector.loadValue();
+    VectorTy *vectorTy = dynamic_cast<VectorTy *>(load.getTy().get());
+    if (!vectorTy)
+        complain("Eisdrache::reduce(): Local is not a vector (%"+vector.getName()+").");
+    
+    Ty::Ptr elementTy = vectorTy->getElementTy();
+    Value *v = load.getValuePtr();
+    Value *result = nullptr;
+
+    if (elementTy->isFloatTy()) 
+        switch (op) {
+            case ADD:   result = builder->CreateFAddReduce(ConstantFP::getNegativeZero(elementTy->getTy()), v); break;
+            case MUL:   result = builder->CreateFMulReduce(ConstantFP::get(elementTy->getTy(), 1.0), v); break;
+            case MIN:   result = builder->CreateFPMinReduce(v); break;
+            case MAX:   result = builder->CreateFPMaxReduce(v); break;
+            default:    complain("Eisdrache::reduce(): Operation (ID "+std::to_string(op)+") not implemented for floating points.");
+        }
+    else 
+        switch (op) {
+            case ADD:   result = builder->CreateAddReduce(v); break;
+            case MUL:   result = builder->CreateMulReduce(v); break;
+            case AND:   result = builder->CreateAndReduce(v); break;
+            case OR:    result = builder->CreateOrReduce(v); break;
+            case XOR:   result = builder->CreateXorReduce(v); break;
+            case MIN:   result = builder->CreateIntMinReduce(v, elementTy->isSignedTy()); break;
+            case MAX:   result = builder->CreateIntMaxReduce(v, elementTy->isSignedTy()); break;
+            default:    complain("Eisdrache::reduce(): Operation (ID "+std::to_string(op)+") not implemented.");
+        }
+    
+    // unordered reductions can be computed as a tree
+    if (!ordered && (op == ADD || op == MUL) && elementTy->isFloatTy())
+        dyn_cast<Instruction>(result)->setHasAllowReassoc(true);
+    
+    result->setName(name.empty() ? "reducetmp" : name);
+    return parent->addLocal(Local(shared_from_this(), elementTy, result));
+}
+
+Eisdrache::Local &Eisdrache::maskedLoad(Local &ptr, Local &mask, std::string name) {
+    if (!ptr.getTy()->isPtrTy())
+        complain("Eisdrache::maskedLoad(): Local is not a pointer (%"+ptr.getName()+").");
+    
+    Value *m = loadMask(mask, "Eisdrache::maskedLoad()");
+    ElementCount count = dyn_cast<VectorType>(m->getType())->getElementCount();
+    Ty::Ptr elementTy = dynamic_cast<PtrTy *>(ptr.getTy().get())->getPointeeTy();
+    if (VectorTy *pointeeTy = dynamic_cast<VectorTy *>(elementTy.get()))
+        elementTy = pointeeTy->getElementTy();
+    Ty::Ptr vectorTy = getVectorTy(elementTy, count.getKnownMinValue(), count.isScalable());
+
+    Align align = module->getDataLayout().getABITypeAlign(elementTy->getTy());
+    CallInst *load = builder->CreateMaskedLoad(vectorTy->getTy(), ptr.getValuePtr(), align, m, nullptr, 
+        name.empty() ? ptr.getName()+"_load" : name);
+    annotateAccess(load, ptr.getValuePtr());
+    return parent->addLocal(Local(shared_from_this(), vectorTy, load));
+}
+
+CallInst *Eisdrache::maskedStore(Local &ptr, Local &value, Local &mask) {
+    if (!ptr.getTy()->isPtrTy())
+        return complain("Eisdrache::maskedStore(): Local is not a pointer (%"+ptr.getName()+").");
+    
+    Local &load = value.loadValue();
+    VectorTy *vectorTy = dynamic_cast<VectorTy *>(load.getTy().get());
+    if (!vectorTy)
+        return complain("Eisdrache::maskedStore(): Value is not a vector (%"+value.getName()+").");
+    
+    Align align = module->getDataLayout().getABITypeAlign(vectorTy->getElementTy()->getTy());
+    CallInst *store = builder->CreateMaskedStore(load.getValuePtr(), ptr.getValuePtr(), align, 
+        loadMask(mask, "Eisdrache::maskedStore()"));
+    annotateAccess(store, ptr.getValuePtr());
+    return store;
+}
+
+Eisdrache::Local &Eisdrache::gather(Local &ptrs, Local &mask, std::string name) {
+    Local &load = ptrs.loadValue();
+    VectorTy *ptrsTy = dynamic_cast<VectorTy *>(load.getTy().get());
+    if (!ptrsTy || !ptrsTy->getElementTy()->isPtrTy())
+        complain("Eisdrache::gather(): Local is not a vector of pointers (%"+ptrs.getName()+").");
+    
+    Ty::Ptr elementTy = dynamic_cast<PtrTy *>(ptrsTy->getElementTy().get())->getPointeeTy();
+    Ty::Ptr vectorTy = getVectorTy(elementTy, ptrsTy->getCount(), ptrsTy->getScalable());
+    Align align = module->getDataLayout().getABITypeAlign(elementTy->getTy());
+    Value *gather = builder->CreateMaskedGather(vectorTy->getTy(), load.getValuePtr(), align, 
+        loadMask(mask, "Eisdrache::gather()"), nullptr, name.empty() ? "gathertmp" : name);
+    return parent->addLocal(Local(shared_from_this(), vectorTy, gather));
+}
+
+CallInst *Eisdrache::scatter(Local &ptrs, Local &value, Local &mask) {
+    Local &load = ptrs.loadValue();
+    VectorTy *ptrsTy = dynamic_cast<VectorTy *>(load.getTy().get());
+    if (!ptrsTy || !ptrsTy->getElementTy()->isPtrTy())
+        return complain("Eisdrache::scatter(): Local is not a vector of pointers (%"+ptrs.getName()+").");
+    
+    Ty::Ptr elementTy = dynamic_cast<PtrTy *>(ptrsTy->getElementTy().get())->getPointeeTy();
+    Align align = module->getDataLayout().getABITypeAlign(elementTy->getTy());
+    return builder->CreateMaskedScatter(value.loadValue().getValuePtr(), load.getValuePtr(), align, 
+        loadMask(mask, "Eisdrache::scatter()"));
+}
+
 /// GETTER ///
 
 LLVMContext *Eisdrache::getContext() { return context; }
@@ -1179,6 +2451,10 @@ Eisdrache::Func *Eisdrache::getFunc(std::string name) {
 
 void Eisdrache::setParent(Func *func) { parent = func; }
 
+void Eisdrache::setBuilderInlining(bool enabled) { builderInlining = enabled; }
+
+void Eisdrache::setTBAA(bool enabled) { tbaa = enabled; }
+
 /// PRIVATE ///
 
 Eisdrache::Eisdrache(LLVMContext *context, Module *module, IRBuilder<> *builder, std::string targetTriple) {
@@ -1209,6 +2485,402 @@ Eisdrache::Eisdrache(LLVMContext *context, Module *module, IRBuilder<> *builder,
     module->setDataLayout(targetMachine->createDataLayout());
 }
 
+AllocaInst *Eisdrache::createAlloca(Type *type, std::string name) {
+    BasicBlock &entry = (**parent)->getEntryBlock();
+    BasicBlock::iterator point = entry.begin();
+    // skip previous allocas to keep them in order of declaration
+    while (point != entry.end() && isa<AllocaInst>(*point))
+        point++;
+    IRBuilder<> entryBuilder(&entry, point);
+    AllocaInst *alloca = entryBuilder.CreateAlloca(type, nullptr, name);
+
+    // the innermost scope of the same function
+    for (auto scope = lifetimeScopes.rbegin(); scope != lifetimeScopes.rend(); scope++)
+        if ((*scope)->add(alloca))
+            break;
+
+    return alloca;
+}
+
+Value *Eisdrache::readSSA(int64_t variable, BasicBlock *block) {
+    if (ssaDefs[block].contains(variable))
+        return ssaDefs[block][variable];
+    return readSSARecursive(variable, block);
+}
+
+Value *Eisdrache::readSSARecursive(int64_t variable, BasicBlock *block) {
+    Value *value = nullptr;
+
+    if (!sealedBlocks.count(block)) {                           // predecessors unknown yet
+        PHINode *phi = createPhi(variable, block);
+        incompletePhis[block].push_back({variable, phi});
+        value = phi;
+    } else if (BasicBlock *pred = block->getSinglePredecessor())  // no phi needed
+        value = readSSA(variable, pred);
+    else if (pred_empty(block))                                 // variable was never assigned
+        value = UndefValue::get(ssaVariables[variable].second);
+    else {                                                      // break cycles with an operandless phi
+        PHINode *phi = createPhi(variable, block);
+        writeSSA(variable, block, phi);
+        value = addPhiOperands(variable, phi);
+    }
+
+    writeSSA(variable, block, value);
+    return value;
+}
+
+void Eisdrache::writeSSA(int64_t variable, BasicBlock *block, Value *value) {
+    ssaDefs[block][variable] = value;
+}
+
+PHINode *Eisdrache::createPhi(int64_t variable, BasicBlock *block) {
+    Type *type = ssaVariables[variable].second;
+    std::string name = ssaVariables[variable].first;
+    if (block->empty())
+        return PHINode::Create(type, 0, name, block);
+    return PHINode::Create(type, 0, name, &block->front());
+}
+
+Value *Eisdrache::addPhiOperands(int64_t variable, PHINode *phi) {
+    for (BasicBlock *pred : predecessors(phi->getParent()))
+        phi->addIncoming(readSSA(variable, pred), pred);
+    return tryRemoveTrivialPhi(phi);
+}
+
+Value *Eisdrache::tryRemoveTrivialPhi(PHINode *phi) {
+    Value *same = nullptr;
+    for (Value *op : phi->incoming_values()) {
+        if (op == same || op == phi)
+            continue;
+        if (same)
+            return phi; // phi merges at least two values
+        same = op;
+    }
+
+    if (!same) // phi is unreachable or in a block without predecessors
+        same = UndefValue::get(phi->getType());
+
+    std::vector<WeakVH> users = {};
+    for (User *user : phi->users())
+        if (user != phi && isa<PHINode>(user))
+            users.push_back(user);
+
+    // definitions in ssaDefs follow the replacement
+    WeakTrackingVH result = same;
+    phi->replaceAllUsesWith(same);
+    phi->eraseFromParent();
+
+    // removing this phi might have made its users trivial
+    for (WeakVH &user : users)
+        if (PHINode *userPhi = dyn_cast_or_null<PHINode>(user))
+            tryRemoveTrivialPhi(userPhi);
+
+    return result;
+}
+
+Value *Eisdrache::createDivision(Value *LHS, Value *RHS, bool isSigned, bool remainder, bool exact, std::string name) {
+    ConstantInt *divisor = dyn_cast<ConstantInt>(RHS);
+    IntegerType *type = dyn_cast<IntegerType>(LHS->getType());
+    
+    // the backend handles vectors, division by zero is undefined anyway
+    if (!divisor || !type || divisor->isZero() || type->getBitWidth() < 2 || (isSigned && divisor->getValue().isMinSignedValue())) {
+        if (remainder)
+            return isSigned ? builder->CreateSRem(LHS, RHS, name) : builder->CreateURem(LHS, RHS, name);
+        return isSigned ? builder->CreateSDiv(LHS, RHS, name, exact) : builder->CreateUDiv(LHS, RHS, name, exact);
+    }
+
+    unsigned bits = type->getBitWidth();
+    const APInt &d = divisor->getValue();
+    APInt ad = isSigned ? d.abs() : d;
+    Value *quotient = nullptr;
+
+    if (isSigned && ad.isOne()) {
+        if (remainder)
+            return ConstantInt::get(type, 0);
+        return d.isNegative() ? builder->CreateNeg(LHS, name) : LHS;
+    }
+
+    if (exact && !ad.isPowerOf2()) {
+        // shift out the factors of two and multiply with the inverse of the odd rest (mod 2^bits)
+        unsigned zeros = ad.countTrailingZeros();
+        APInt odd = ad.lshr(zeros);
+        APInt inverse = odd;
+        while (odd * inverse != 1)
+            inverse *= 2 - odd * inverse;
+        Value *shifted = isSigned ? builder->CreateAShr(LHS, zeros, name+"_shift", true) 
+            : builder->CreateLShr(LHS, zeros, name+"_shift", true);
+        quotient = builder->CreateMul(shifted, ConstantInt::get(type, inverse), isSigned && d.isNegative() ? name+"_abs" : name);
+    } else if (!isSigned && d.isPowerOf2()) {
+        if (remainder)
+            return builder->CreateAnd(LHS, ConstantInt::get(type, d - 1), name);
+        return builder->CreateLShr(LHS, d.logBase2(), name, exact);
+    } else if (!isSigned) {
+        // Granlund & Montgomery, Division by Invariant Integers using Multiplication, Figure 4.1
+        unsigned l = d.ceilLogBase2();
+        APInt magic = (APInt::getOneBitSet(2 * bits + 1, bits) * (APInt::getOneBitSet(2 * bits + 1, l) - d.zext(2 * bits + 1)))
+            .udiv(d.zext(2 * bits + 1)) + 1;
+        Value *high = createMulHigh(LHS, magic.trunc(bits), false, name+"_mulhi");
+        Value *difference = builder->CreateLShr(builder->CreateSub(LHS, high, name+"_diff"), 1, name+"_half");
+        quotient = builder->CreateLShr(builder->CreateAdd(high, difference, name+"_sum"), l - 1, remainder ? name+"_quot" : name);
+    } else if (ad.isPowerOf2()) {
+        // round towards zero: add divisor - 1 to negative dividends before shifting
+        unsigned k = ad.logBase2();
+        if (exact)
+            quotient = builder->CreateAShr(LHS, k, name+"_abs", true);
+        else {
+            Value *sign = builder->CreateAShr(LHS, bits - 1, name+"_sign");
+            Value *bias = builder->CreateLShr(sign, bits - k, name+"_bias");
+            quotient = builder->CreateAShr(builder->CreateAdd(LHS, bias, name+"_biased"), k, name+"_abs");
+        }
+    } else {
+        // Granlund & Montgomery, Division by Invariant Integers using Multiplication, Figure 5.2
+        unsigned l = std::max(ad.ceilLogBase2(), 1u);
+        APInt magic = APInt::getOneBitSet(2 * bits + 1, bits + l - 1).udiv(ad.zext(2 * bits + 1)) + 1;
+        Value *high = createMulHigh(LHS, magic.trunc(bits), true, name+"_mulhi");
+        Value *sum = builder->CreateAdd(LHS, high, name+"_sum");
+        Value *sign = builder->CreateAShr(LHS, bits - 1, name+"_sign");
+        quotient = builder->CreateSub(builder->CreateAShr(sum, l - 1, name+"_shift"), sign, name+"_abs");
+    }
+
+    if (isSigned && d.isNegative())
+        quotient = builder->CreateNeg(quotient, remainder ? name+"_quot" : name);
+    else if (isSigned && remainder) 
+        quotient->setName(name+"_quot");
+    else if (isSigned)
+        quotient->setName(name);
+
+    if (remainder)
+        return builder->CreateSub(LHS, builder->CreateMul(quotient, divisor, name+"_prod"), name);
+    return quotient;
+}
+
+Value *Eisdrache::createMulHigh(Value *LHS, const APInt &RHS, bool isSigned, std::string name) {
+    unsigned bits = RHS.getBitWidth();
+    Type *wideTy = builder->getIntNTy(2 * bits);
+    Value *wide = isSigned ? builder->CreateSExt(LHS, wideTy) : builder->CreateZExt(LHS, wideTy);
+    Value *factor = ConstantInt::get(wideTy, isSigned ? RHS.sext(2 * bits) : RHS.zext(2 * bits));
+    Value *product = builder->CreateMul(wide, factor);
+    return builder->CreateTrunc(builder->CreateLShr(product, bits), LHS->getType(), name);
+}
+
+Eisdrache::Local &Eisdrache::createIntrinsic(Intrinsic::ID id, std::vector<Local *> operands, bool floating, 
+    std::string caller, std::string name) {
+    ValueVec args = {};
+    Ty::Ptr ty = nullptr;
+    for (Local *operand : operands) {
+        Local &load = operand->loadValue();
+        if (floating ? !load.getTy()->isFloatTy() : !load.getTy()->isIntTy())
+            complain(caller+": Local is not "+(floating ? "a floating point" : "an integer")+" (%"+operand->getName()+").");
+        if (!args.empty() && load.getValuePtr()->getType() != args.front()->getType())
+            complain(caller+": Operands have different types (%"+operand->getName()+").");
+        if (!ty) 
+            ty = load.getTy();
+        args.push_back(load.getValuePtr());
+    }
+
+    Value *result = builder->CreateIntrinsic(id, {args.front()->getType()}, args, nullptr, name);
+    return parent->addLocal(Local(shared_from_this(), ty, result));
+}
+
+Eisdrache::WrapScope::Flags Eisdrache::getWrapFlags() {
+    if (wrapScopes.empty())
+        return WrapScope::Flags{false, false, false};
+    return wrapScopes.back()->getFlags();
+}
+
+Align Eisdrache::getAtomicAlign(Local &ptr, std::string caller) {
+    if (!ptr.getTy()->isPtrTy())
+        complain(caller+": Local is not a pointer (%"+ptr.getName()+").");
+    
+    Ty::Ptr ty = dynamic_cast<PtrTy *>(ptr.getTy().get())->getPointeeTy();
+    Type *type = ty->getTy();
+    if (!type->isIntegerTy() && !type->isFloatingPointTy() && !type->isPointerTy())
+        complain(caller+": Pointee is not an integer, floating point or pointer (%"+ptr.getName()+").");
+
+    uint64_t bits = module->getDataLayout().getTypeSizeInBits(type);
+    if (bits < 8 || !isPowerOf2_64(bits))
+        complain(caller+": Size of pointee is not a power of two of at least 8 bits (%"+ptr.getName()+").");
+    return Align(bits / 8);
+}
+
+void Eisdrache::annotateAccess(Instruction *inst, Value *ptr) {
+    Type *accessTy = nullptr;
+    if (LoadInst *load = dyn_cast<LoadInst>(inst))
+        accessTy = load->getType();
+    else if (StoreInst *store = dyn_cast<StoreInst>(inst))
+        accessTy = store->getValueOperand()->getType();
+    else if (AtomicRMWInst *rmw = dyn_cast<AtomicRMWInst>(inst))
+        accessTy = rmw->getValOperand()->getType();
+    else if (AtomicCmpXchgInst *cmpxchg = dyn_cast<AtomicCmpXchgInst>(inst))
+        accessTy = cmpxchg->getCompareOperand()->getType();
+    
+    if (tbaa && accessTy)
+        if (MDNode *tag = getTBAATag(accessTy, ptr))
+            inst->setMetadata(LLVMContext::MD_tbaa, tag);
+
+    for (AliasScope *scope : aliasScopes)
+        scope->annotate(inst, ptr);
+}
+
+MDNode *Eisdrache::getTBAATypeNode(Type *type) {
+    MDBuilder md = MDBuilder(*context);
+    if (tbaaTypes.empty()) {
+        MDNode *root = md.createTBAARoot("Eisdrache TBAA");
+        tbaaTypes[builder->getInt8Ty()] = md.createTBAAScalarTypeNode("omnipotent char", root);
+    }
+    if (tbaaTypes.contains(type))
+        return tbaaTypes.at(type);
+    
+    MDNode *node = nullptr;
+    if (StructType *structTy = dyn_cast<StructType>(type)) {
+        const StructLayout *layout = module->getDataLayout().getStructLayout(structTy);
+        std::vector<std::pair<MDNode *, uint64_t>> fields = {};
+        for (unsigned i = 0; i < structTy->getNumElements(); i++)
+            fields.push_back({getTBAATypeNode(structTy->getElementType(i)), layout->getElementOffset(i)});
+        node = md.createTBAAStructTypeNode(structTy->hasName() ? structTy->getName() : "anon", fields);
+    } else if (type->isIntegerTy() || type->isFloatingPointTy() || type->isPointerTy()) {
+        std::string name;
+        raw_string_ostream os(name);
+        type->print(os);
+        node = md.createTBAAScalarTypeNode(os.str(), tbaaTypes.at(builder->getInt8Ty()));
+    } else 
+        return tbaaTypes.at(builder->getInt8Ty()); // vectors and arrays may alias anything
+    
+    tbaaTypes[type] = node;
+    return node;
+}
+
+MDNode *Eisdrache::getTBAATag(Type *accessTy, Value *ptr) {
+    if (!accessTy->isIntegerTy() && !accessTy->isFloatingPointTy() && !accessTy->isPointerTy())
+        return nullptr;
+    
+    MDBuilder md = MDBuilder(*context);
+    MDNode *scalar = getTBAATypeNode(accessTy);
+    
+    // struct-path: &base->field(->field...)
+    GEPOperator *gep = dyn_cast<GEPOperator>(ptr);
+    if (gep && gep->getSourceElementType()->isStructTy() && gep->getNumIndices() >= 2 
+        && gep->hasAllConstantIndices() && cast<ConstantInt>(gep->getOperand(1))->isZero()) {
+        StructType *base = cast<StructType>(gep->getSourceElementType());
+        Type *field = base;
+        uint64_t offset = 0;
+        for (unsigned i = 2; i <= gep->getNumIndices() && field; i++) {
+            StructType *structTy = dyn_cast<StructType>(field);
+            if (!structTy) {
+                field = nullptr;
+                break;
+            }
+            uint64_t index = cast<ConstantInt>(gep->getOperand(i))->getZExtValue();
+            offset += module->getDataLayout().getStructLayout(structTy)->getElementOffset(index);
+            field = structTy->getElementType(index);
+        }
+        if (field == accessTy)
+            return md.createTBAAStructTagNode(getTBAATypeNode(base), scalar, offset);
+    }
+
+    return md.createTBAAStructTagNode(scalar, scalar, 0);
+}
+
+bool Eisdrache::spliceCall(Function *callee, ValueVec args, std::string name, Value *&result) {
+    if (callee->isDeclaration() || callee->isVarArg() || !callee->hasFnAttribute(Attribute::AlwaysInline)
+        || callee->size() != 1 || callee->arg_size() != args.size())
+        return false;
+    // a recursive call would clone the block it is inserted into
+    if (callee == builder->GetInsertBlock()->getParent())
+        return false;
+    
+    // the callee may still be under construction
+    ReturnInst *ret = dyn_cast_or_null<ReturnInst>(callee->getEntryBlock().getTerminator());
+    if (!ret)
+        return false;
+    for (Instruction &inst : callee->getEntryBlock()) {
+        if (isa<AllocaInst>(inst))
+            return false;
+        // a musttail call has to stay in front of a return
+        if (CallInst *call = dyn_cast<CallInst>(&inst))
+            if (call->isMustTailCall())
+                return false;
+    }
+    for (size_t i = 0; i < args.size(); i++)
+        if (args[i]->getType() != callee->getArg(i)->getType())
+            return false;
+
+    ValueToValueMapTy map;
+    for (size_t i = 0; i < args.size(); i++)
+        map[callee->getArg(i)] = args[i];
+    
+    for (Instruction &inst : callee->getEntryBlock()) {
+        if (&inst == ret)
+            break;
+        Instruction *clone = inst.clone();
+        // the scopes only hold within one instance of the callee
+        clone->setMetadata(LLVMContext::MD_alias_scope, nullptr);
+        clone->setMetadata(LLVMContext::MD_noalias, nullptr);
+        // arguments may point to allocas of the caller now, like llvm::InlineFunction drop the tail marker
+        if (CallInst *call = dyn_cast<CallInst>(clone))
+            call->setTailCallKind(CallInst::TCK_None);
+        RemapInstruction(clone, map, RF_NoModuleLevelChanges | RF_IgnoreMissingLocals);
+        builder->Insert(clone, inst.getName());
+        map[&inst] = clone;
+    }
+
+    result = nullptr;
+    if (Value *value = ret->getReturnValue()) {
+        result = map.count(value) ? (Value *) map[value] : value;
+        if (!name.empty() && isa<Instruction>(result) && map.count(value) && !isa<Argument>(value))
+            result->setName(name);
+    }
+    return true;
+}
+
+CallInst *Eisdrache::createCall(Function *callee, ValueVec args, std::string name) {
+    CallInst *inst = builder->CreateCall(callee, args, name);
+    // a call with a different convention than the callee is undefined behavior
+    inst->setCallingConv(callee->getCallingConv());
+    return inst;
+}
+
+void Eisdrache::setCallingConv(Function *func, CallingConv::ID conv) {
+    func->setCallingConv(conv);
+    for (User *user : func->users())
+        if (CallBase *call = dyn_cast<CallBase>(user))
+            if (call->getCalledFunction() == func)
+                call->setCallingConv(conv);
+}
+
+MaybeAlign Eisdrache::getPointeeAlign(Local &ptr, std::string caller) {
+    PtrTy *ptrTy = dynamic_cast<PtrTy *>(ptr.getTy().get());
+    if (!ptrTy)
+        complain(caller+": Local is not a pointer (%"+ptr.getName()+").");
+    
+    Type *pointee = ptrTy->getPointeeTy()->getTy();
+    if (!pointee->isSized())
+        return MaybeAlign(1);
+    return module->getDataLayout().getABITypeAlign(pointee);
+}
+
+LoadInst *Eisdrache::getLoadInst(Local &load, std::string caller) {
+    LoadInst *inst = dyn_cast<LoadInst>(load.getValuePtr());
+    if (!inst)
+        complain(caller+": Local is not a load (%"+load.getName()+").");
+    return inst;
+}
+
+Value *Eisdrache::loadMask(Local &mask, std::string caller) {
+    Value *m = mask.loadValue().getValuePtr();
+    VectorType *maskTy = dyn_cast<VectorType>(m->getType());
+    if (!maskTy || !maskTy->getElementType()->isIntegerTy(1))
+        complain(caller+": Mask is not a vector of booleans (%"+mask.getName()+").");
+    return m;
+}
+
+Value *Eisdrache::loadBytes(Local &bytes, std::string caller) {
+    Value *b = bytes.loadValue().getValuePtr();
+    if (!b->getType()->isIntegerTy())
+        complain(caller+": Amount of bytes is not an integer (%"+bytes.getName()+").");
+    return b;
+}
+
 std::nullptr_t Eisdrache::complain(std::string message) {
     std::cerr << "\033[31mError\033[0m: " << message << "\n"; 
     exit(1);
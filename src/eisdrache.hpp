@@ -15,7 +15,9 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <set>
 
+#include <llvm/Config/llvm-config.h>
 #include <llvm/PassRegistry.h>
 #include <llvm/InitializePasses.h>
 #include <llvm/IR/LLVMContext.h>
@@ -24,6 +26,18 @@
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/Operator.h>
+#include <llvm/IR/ValueMap.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+#include <llvm/Transforms/Utils/BuildLibCalls.h>
+#include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/Analysis/CaptureTracking.h>
+#if LLVM_VERSION_MAJOR < 16
+#include <llvm/Analysis/AliasAnalysis.h> // ModRefInfo
+#endif
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
 #include <llvm/Support/TargetSelect.h>
@@ -57,6 +71,8 @@ public:
         AND,    // bit and              &
         LSH,    // left bit shift       <<
         RSH,    // right bit shift      >>
+        MIN,    // minimum              min
+        MAX,    // maximum              max
 
         EQU,    // equals               ==
         NEQ,    // not equals           !=
@@ -69,6 +85,12 @@ public:
         NOT,    // bit not              ~
     };
 
+    // Branch Probabilities
+    enum Branch {
+        LIKELY,     // condition is almost always true
+        UNLIKELY,   // condition is almost always false
+    };
+
     /**
      * @brief Parent class for references, locals, functions, ...
      * 
@@ -90,6 +112,7 @@ public:
             INT,
             FLOAT,
             STRUCT,
+            VECTOR,
             NONE,
         };
 
@@ -123,8 +146,11 @@ public:
         virtual bool isEqual(const Ptr comp) const = 0;
 
         constexpr bool isPtrTy() const;
+        // integer or vector of integers
         constexpr bool isIntTy() const;
+        // floating point or vector of floating points
         constexpr bool isFloatTy() const;
+        constexpr bool isVectorTy() const;
         constexpr bool isSignedTy();
 
         virtual Kind kind() const = 0;
@@ -184,9 +210,11 @@ public:
         using Ptr = std::shared_ptr<PtrTy>;
         using Vec = std::vector<Ptr>;
 
-        PtrTy(Eisdrache::Ptr eisdrache, Ty::Ptr pointee);
+        PtrTy(Eisdrache::Ptr eisdrache, Ty::Ptr pointee, bool noAlias = false);
 
         Ty::Ptr &getPointeeTy();
+        // the pointer does not alias any other pointer (noalias parameter)
+        bool isRestrict() const;
         
         size_t getBit() const override;
 
@@ -199,6 +227,7 @@ public:
 
     private:
         Ty::Ptr pointee;
+        bool noAlias;
     };
 
     class IntTy : public Ty {
@@ -245,6 +274,39 @@ public:
         size_t bit;
     };
 
+    /**
+     * @brief Type representing a SIMD vector of integers, floating points or pointers.
+     *      Operations on vectors are applied element-wise.
+     * 
+     */
+    class VectorTy : public Ty {
+    public:
+        using Ptr = std::shared_ptr<VectorTy>;
+        using Vec = std::vector<Ptr>;
+
+        VectorTy(Eisdrache::Ptr eisdrache, Ty::Ptr elementTy, size_t count, bool scalable = false);
+
+        Ty::Ptr getElementTy() const;
+        // get the amount of elements (multiplied by vscale if scalable)
+        const size_t &getCount() const;
+        const bool &getScalable() const;
+
+        // get the bits of a single element
+        size_t getBit() const override;
+
+        Type *getTy() const override;
+
+        bool isValidRHS(const Ty::Ptr comp) const override;
+        bool isEqual(const Ty::Ptr comp) const override;
+
+        Kind kind() const override;
+
+    private:
+        Ty::Ptr elementTy;
+        size_t count;
+        bool scalable;
+    };
+
     /**
      * @brief A reference to a symbol (local, function, ...).
      * 
@@ -278,6 +340,9 @@ public:
      * * wether the value is a llvm::AllocaInst,
      * * and the value to be assigned once the value is referenced. 
      * (Relevant for llvm::AllocaInst)
+     * 
+     * Locals declared with Eisdrache::declareSSA() hold no value themselves,
+     * their current value is looked up in the current llvm::BasicBlock instead.
      */
     class Local : public Entity {
     public:
@@ -296,13 +361,16 @@ public:
         void setFuture(Value *future);
         void setFutureArgs(ValueVec args);
         void setTy(Ty::Ptr ty);
+        void setSSA(int64_t variable);
 
         AllocaInst *getAllocaPtr();
         Value *getValuePtr();
         Ty::Ptr getTy();
         std::string getName() const;
+        int64_t getSSA() const;
 
         bool isAlloca();
+        bool isSSA() const;
 
         /**
          * @brief Load the value stored at the adress of the local.
@@ -331,6 +399,7 @@ public:
         Ty::Ptr type;
         Value *future;
         ValueVec future_args;
+        int64_t ssa = -1; // index of the SSA variable, -1 if this is no SSA variable
         Eisdrache::Ptr eisdrache;
     };
 
@@ -350,8 +419,16 @@ public:
         using Vec = std::vector<Func>;
         using Map = std::map<std::string, Func>;
 
+        enum InlinePolicy {
+            ALWAYS_INLINE,  // alwaysinline
+            INLINE_HINT,    // inlinehint
+            NO_INLINE,      // noinline
+            COLD,           // cold (rarely executed, not inlined eagerly)
+        };
+
         Func();
-        Func(Eisdrache::Ptr eisdrache, Ty::Ptr type, std::string name, Ty::Map parameters, bool entry = false);
+        Func(Eisdrache::Ptr eisdrache, Ty::Ptr type, std::string name, Ty::Map parameters, bool entry = false, 
+            GlobalValue::LinkageTypes linkage = GlobalValue::ExternalLinkage);
         ~Func();
 
         Func &operator=(const Func &copy);
@@ -367,6 +444,11 @@ public:
         // call this function
         Local &call(ValueVec args = {}, std::string name = "");
         Local &call(Local::Vec args = {}, std::string name = "");
+        // call this function as a tail call from the current parent (no tail marker unless the callee provably can not
+        // reach allocas or byval arguments of the caller, i.e. no alloca is captured and no argument derives from one),
+        // a musttail call checks that the prototypes match and returns its result
+        Local &tailCall(ValueVec args = {}, bool mustTail = false, std::string name = "");
+        Local &tailCall(Local::Vec args = {}, bool mustTail = false, std::string name = "");
         // add a local variable to this function
         // and return reference to copy of local
         Local &addLocal(Local local);
@@ -375,11 +457,36 @@ public:
         void addAttr(Attribute attr, int64_t index = -1);
         void addAttr(Attribute::AttrKind attr, int64_t index = -1);
 
-        // set the calling convention of the function
+        // set the calling convention of the function and its existing call sites
         void setCallingConv(CallingConv::ID conv);
+        // set the linkage of the function (internal, private, linkonce_odr, external, ...)
+        void setLinkage(GlobalValue::LinkageTypes linkage);
+        // set the visibility of the function (default, hidden, protected)
+        void setVisibility(GlobalValue::VisibilityTypes visibility);
+        // set the inline policy of the function, replaces the previous policy
+        void setInlinePolicy(InlinePolicy policy);
 
         // toggle no exception 
         void setDoesNotThrow();
+#if LLVM_VERSION_MAJOR >= 16
+        // set the memory the function may access (e.g. MemoryEffects::argMemOnly(ModRefInfo::Ref))
+        void setMemoryEffects(MemoryEffects effects);
+#endif
+        // the function always returns (no infinite loops, no exit)
+        void setWillReturn();
+        // the function does not synchronize with other threads
+        void setNoSync();
+        // the function does not free memory
+        void setNoFree();
+
+        /**
+         * @brief Set the floating point attributes of the function 
+         *      ("unsafe-fp-math", "no-nans-fp-math", "no-infs-fp-math", ...)
+         *      so the backend may apply the same relaxations as the fast-math flags.
+         * 
+         * @param flags Allowed relaxations
+         */
+        void setFastMath(FastMathFlags flags);
 
         Ty::Ptr getTy();
 
@@ -431,9 +538,13 @@ public:
          * @param type Type of returned value
          * @param name Function name
          * @param args Additional parameters
+         * @param linkage (optional) Linkage of the function
+         * @param validThis (optional) Mark `this` nonnull, dereferenceable and aligned 
+         *      (only if the function is never called with a null or partially allocated object)
          * @return Func * 
          */
-        Func *createMemberFunc(Ty::Ptr type, std::string name, Ty::Map args = Ty::Map());
+        Func *createMemberFunc(Ty::Ptr type, std::string name, Ty::Map args = Ty::Map(), 
+            GlobalValue::LinkageTypes linkage = GlobalValue::ExternalLinkage, bool validThis = false);
 
         Type *getTy() const override;
 
@@ -469,7 +580,15 @@ public:
             SET_AT_INDEX,
         };
 
-        Array(Eisdrache::Ptr eisdrache = nullptr, Ty::Ptr elementTy = nullptr, std::string name = "");
+        /**
+         * @brief Construct a new Array type and its member functions.
+         * 
+         * @param eisdrache 
+         * @param elementTy Type of the elements
+         * @param name Name of the struct type
+         * @param prefetchDistance (optional) get_at_index prefetches the element this many indices ahead (0: off)
+         */
+        Array(Eisdrache::Ptr eisdrache = nullptr, Ty::Ptr elementTy = nullptr, std::string name = "", size_t prefetchDistance = 0);
         ~Array();
 
         Local &allocate(std::string name = "");
@@ -477,6 +596,10 @@ public:
         Local &call(Member callee, Local::Vec args = {}, std::string name = "");
 
     private:
+        // mark a member without side effects besides reading / writing `this` (argMem) and the buffer (otherMem),
+        // and prefetching if requested
+        void markAccessor(Func *member, ModRefInfo argMem, ModRefInfo otherMem = ModRefInfo::NoModRef, bool prefetches = false);
+
         std::string name;
         Struct::Ptr self;
         Ty::Ptr elementTy;
@@ -502,6 +625,196 @@ public:
         Eisdrache::Ptr eisdrache;
     };
 
+    /**
+     * @brief Builder for counted loops.
+     * 
+     * Creates a loop in canonical form (preheader, header, body, latch and exit) 
+     * with an induction variable counting from `begin` up to `end` (exclusive).
+     * The hints are attached to the backedge as `llvm.loop` metadata.
+     * 
+     * @example
+     * Eisdrache::Loop::Hints hints = {.vectorize = true, .interleaveCount = 4};
+     * Eisdrache::Loop loop = Eisdrache::Loop(eisdrache, begin, end, hints, "loop");
+     * Eisdrache::Local &index = loop.getIndex();
+     * // ... body ...
+     * loop.close(); // continue at %loop_exit
+     */
+    class Loop {
+    public:
+        struct Hints {
+            bool vectorize = false;         // llvm.loop.vectorize.enable
+            unsigned vectorizeWidth = 0;    // llvm.loop.vectorize.width (0 = let LLVM decide)
+            unsigned interleaveCount = 0;   // llvm.loop.interleave.count (0 = let LLVM decide)
+            unsigned unrollCount = 0;       // llvm.loop.unroll.count (0 = let LLVM decide)
+            bool unrollFull = false;        // llvm.loop.unroll.full
+            bool mustProgress = true;       // llvm.loop.mustprogress
+        };
+
+        /**
+         * @brief Start a counted loop and set the insertion point to its body.
+         * 
+         * @param eisdrache Eisdrache Wrapper
+         * @param begin First value of the induction variable
+         * @param end Upper bound of the induction variable (exclusive)
+         * @param name (optional) Prefix for the names of blocks and values
+         */
+        Loop(Eisdrache::Ptr eisdrache, Local &begin, Local &end, std::string name = "loop");
+        /**
+         * @brief Start a counted loop and set the insertion point to its body.
+         * 
+         * @param eisdrache Eisdrache Wrapper
+         * @param begin First value of the induction variable
+         * @param end Upper bound of the induction variable (exclusive)
+         * @param hints Vectorization and unroll hints
+         * @param name (optional) Prefix for the names of blocks and values
+         */
+        Loop(Eisdrache::Ptr eisdrache, Local &begin, Local &end, Hints hints, std::string name = "loop");
+
+        // get the induction variable
+        Local &getIndex();
+        // get the latch (jump here to continue)
+        BasicBlock *getLatch();
+        // get the exit block (jump here to break)
+        BasicBlock *getExit();
+
+        // close the body, create the latch and set the insertion point to the exit block
+        void close();
+
+    private:
+        MDNode *createMetadata();
+
+        std::string name;
+        Hints hints;
+        Local *index;
+        PHINode *phi;
+        BasicBlock *header;
+        BasicBlock *latch;
+        BasicBlock *exit;
+
+        Eisdrache::Ptr eisdrache;
+    };
+
+    /**
+     * @brief RAII scope for the lifetime of locals.
+     * 
+     * Every alloca created while this scope exists starts its lifetime (llvm.lifetime.start) at its declaration
+     * and ends it (llvm.lifetime.end) when the scope is destroyed, so stack slots of different scopes can be reused.
+     * The scope belongs to the function it was created in, allocas of other functions are ignored.
+     * The lifetimes only end on the path the builder is on when the scope is destroyed,
+     * so a scope must not span control flow (branches out of the scope or returns).
+     * 
+     * @example
+     * {
+     *      Eisdrache::LifetimeScope scope = Eisdrache::LifetimeScope(eisdrache);
+     *      Eisdrache::Local &tmp = eisdrache->allocateStruct(pair, "tmp");
+     * } // call void @llvm.lifetime.end.p0(i64 16, ptr %tmp)
+     */
+    class LifetimeScope {
+    public:
+        LifetimeScope(Eisdrache::Ptr eisdrache);
+        LifetimeScope(const LifetimeScope &copy) = delete;
+        ~LifetimeScope();
+
+        // start the lifetime of an alloca and end it with this scope,
+        // returns false if the alloca belongs to another function
+        bool add(AllocaInst *alloca);
+
+    private:
+        std::vector<AllocaInst *> allocas;
+        Function *function;
+
+        Eisdrache::Ptr eisdrache;
+    };
+
+    /**
+     * @brief RAII scope for overflow and bounds semantics.
+     * 
+     * While this scope exists, integer arithmetic (add, sub, mul, shl) of signed operands
+     * is emitted with the nsw flag, of unsigned operands with the nuw flag (if enabled),
+     * and Eisdrache::getArrayElement() emits inbounds GEPs.
+     * Overflowing or indexing out of bounds inside such a scope yields poison.
+     * 
+     * @example
+     * {
+     *      Eisdrache::WrapScope scope = Eisdrache::WrapScope(eisdrache);
+     *      eisdrache->binaryOp(Eisdrache::ADD, a, b); // %addtmp = add nsw i32 %a, %b
+     * }
+     */
+    class WrapScope {
+    public:
+        struct Flags {
+            bool noSignedWrap = true;       // signed arithmetic does not overflow
+            bool noUnsignedWrap = false;    // unsigned arithmetic does not overflow
+            bool inBounds = true;           // array indices stay within the array
+        };
+
+        WrapScope(Eisdrache::Ptr eisdrache);
+        WrapScope(Eisdrache::Ptr eisdrache, Flags flags);
+        WrapScope(const WrapScope &copy) = delete;
+        ~WrapScope();
+
+        const Flags &getFlags() const;
+
+    private:
+        Flags flags;
+
+        Eisdrache::Ptr eisdrache;
+    };
+
+    /**
+     * @brief RAII scope for fast-math flags.
+     * 
+     * Every floating point instruction created while this scope exists 
+     * (fadd, fsub, fmul, fdiv, frem, fcmp and floating point intrinsics) carries the given fast-math flags.
+     * The previous flags are restored when the scope is destroyed.
+     * 
+     * @example
+     * {
+     *      Eisdrache::FastMathScope scope = Eisdrache::FastMathScope(eisdrache);
+     *      eisdrache->binaryOp(Eisdrache::MUL, x, y); // %multmp = fmul fast double %x, %y
+     * }
+     */
+    class FastMathScope {
+    public:
+        // all flags (reassoc, contract, nnan, ninf, nsz, arcp, afn)
+        FastMathScope(Eisdrache::Ptr eisdrache);
+        FastMathScope(Eisdrache::Ptr eisdrache, FastMathFlags flags);
+        FastMathScope(const FastMathScope &copy) = delete;
+        ~FastMathScope();
+
+    private:
+        IRBuilderBase::FastMathFlagGuard guard;
+    };
+
+    /**
+     * @brief RAII scope for scoped alias metadata.
+     * 
+     * Asserts that the given base pointers do not alias each other while this scope exists.
+     * Every load and store created in this scope, whose address is based on one of the base pointers,
+     * gets the scope of its base in `!alias.scope` and the scopes of all other bases in `!noalias`.
+     * Unlike noalias parameters, the metadata is kept when the function is inlined.
+     * 
+     * @example
+     * {
+     *      Eisdrache::AliasScope scope = Eisdrache::AliasScope(eisdrache, {&in, &out});
+     *      eisdrache->storeValue(out, in.loadValue(true)); // store ..., !alias.scope !0, !noalias !1
+     * }
+     */
+    class AliasScope {
+    public:
+        AliasScope(Eisdrache::Ptr eisdrache, std::vector<Local *> bases, std::string name = "scope");
+        AliasScope(const AliasScope &copy) = delete;
+        ~AliasScope();
+
+        // annotate an access of a pointer, if it is based on one of the base pointers
+        void annotate(Instruction *inst, Value *ptr);
+
+    private:
+        std::vector<std::pair<const Value *, Metadata *>> scopes; // underlying object and its scope
+
+        Eisdrache::Ptr eisdrache;
+    };
+
     ~Eisdrache();
 
     // Initialize the LLVM API
@@ -540,6 +853,10 @@ public:
     Ty::Ptr getFloatPtrTy(size_t bit);
     // Type: 16 = half**, 32 = float**, 64 = double**
     Ty::Ptr getFloatPtrPtrTy(size_t bit);
+    // Type: <count x element> or <vscale x count x element>
+    Ty::Ptr getVectorTy(Ty::Ptr elementTy, size_t count, bool scalable = false);
+    // Type: pointee* restrict (parameters of this type are noalias)
+    Ty::Ptr getRestrictPtrTy(Ty::Ptr pointee);
 
     /// VALUES ///
 
@@ -555,6 +872,24 @@ public:
     
     ConstantPointerNull *getNullPtr(Ty::Ptr ptrTy);
 
+    // Bytes written by a store of the type (i1: 1, i36: 5)
+    uint64_t sizeOf(Ty::Ptr type);
+    // Bytes between two elements of the type in an array, including padding
+    uint64_t allocSizeOf(Ty::Ptr type);
+    // ABI alignment of the type in bytes
+    uint64_t alignOf(Ty::Ptr type);
+    // Offset of the element at index in bytes
+    uint64_t offsetOf(Struct::Ptr type, size_t index);
+
+    // Eisdrache::sizeOf() as i64 constant
+    ConstantInt *getSizeOf(Ty::Ptr type);
+    // Eisdrache::allocSizeOf() as i64 constant
+    ConstantInt *getAllocSizeOf(Ty::Ptr type);
+    // Eisdrache::alignOf() as i64 constant
+    ConstantInt *getAlignOf(Ty::Ptr type);
+    // Eisdrache::offsetOf() as i64 constant
+    ConstantInt *getOffsetOf(Struct::Ptr type, size_t index);
+
     /// FUNCTIONS ///
     
     /**
@@ -573,9 +908,26 @@ public:
      * @param name name of the function
      * @param parameters (optional) parameters of the function 
      * @param entry (optional) creates entry llvm::BasicBlock in function body if true
+     * @param linkage (optional) linkage of the function (functions without entry have to be external)
      * @return Func & - Eisdrache::Func (wrapped llvm::Function)
      */
-    Func &declareFunction(Ty::Ptr type, std::string name, Ty::Map parameters = Ty::Map(), bool entry = false);
+    Func &declareFunction(Ty::Ptr type, std::string name, Ty::Map parameters = Ty::Map(), bool entry = false, 
+        GlobalValue::LinkageTypes linkage = GlobalValue::ExternalLinkage);
+
+    /**
+     * @brief Declare a function of the C library (e.g. malloc, free, strlen) 
+     *      with the attributes LLVM knows for it (allocsize, allockind, noalias return, nocapture, ...),
+     *      so it is recognized as builtin. Does not change the current parent.
+     *      Returns the existing function if it was declared already.
+     * 
+     * @param type return type of the function
+     * @param name name of the function
+     * @param parameters parameters of the function 
+     * @param fallback (optional) Keep a plain declaration instead of complaining 
+     *      if the target does not provide the function (e.g. GPU targets)
+     * @return Func & - Eisdrache::Func (wrapped llvm::Function)
+     */
+    Func &declareLibFunc(Ty::Ptr type, std::string name, Ty::Vec parameters, bool fallback = false);
     
     /**
      * @brief Get the Eisdrache::Func wrapper object
@@ -587,6 +939,7 @@ public:
 
     /**
      * @brief Verify that a Eisdrache::Func is free of errors.
+     *          Seals all remaining blocks of the function (see Eisdrache::sealBlock()).
      *          TODO: Implement this function.
      * @param wrap Eisdrache::Func (wrapped llvm::Function)
      * @return true - Eisdrache::Func is error-free.
@@ -594,6 +947,34 @@ public:
      */
     bool verifyFunc(Func &wrap);
 
+    // result of Eisdrache::internalize()
+    struct InternalizeStats {
+        size_t internalized = 0;        // functions changed to internal linkage
+        size_t removed = 0;             // unused functions removed from the module
+        size_t instructionsBefore = 0;  // instructions in the module before 
+        size_t instructionsAfter = 0;   // and after internalization
+    };
+
+    /**
+     * @brief Give every defined function, except the entry points, internal linkage
+     *      and remove all functions with local or linkonce linkage that are not used anymore.
+     *      Call this after code generation, Eisdrache::Func of removed functions are invalidated.
+     * 
+     * @param keep (optional) Names of the entry points, which stay external
+     * @return InternalizeStats 
+     */
+    InternalizeStats internalize(std::set<std::string> keep = {"main"});
+
+    /**
+     * @brief Switch internal functions, whose address is not taken, to the fast calling convention 
+     *      and update their call sites. Functions linked by musttail calls keep a common convention.
+     *      Call this after code generation (e.g. after Eisdrache::internalize()).
+     * 
+     * @param group (optional) Names of the functions to consider, all functions if empty
+     * @return size_t - Number of functions switched to fastcc
+     */
+    size_t useFastCallingConv(std::set<std::string> group = {});
+
     /**
      * @brief Call a llvm::Function by its wrap.
      * 
@@ -647,6 +1028,42 @@ public:
      */
     Local &declareLocal(Ty::Ptr type, std::string name = "", Value *future = nullptr, ValueVec future_args = ValueVec());
 
+    /**
+     * @brief Declare a local variable in SSA form. 
+     *      Instead of allocating memory, the current value of the variable is tracked per llvm::BasicBlock
+     *      and phi nodes are inserted where the control flow joins.
+     * 
+     * @param type Type of the variable
+     * @param name (optional) Name of the variable
+     * @param value (optional) Initial value of the variable
+     * @return Local & - Wrapped variable
+     */
+    Local &declareSSA(Ty::Ptr type, std::string name = "", Value *value = nullptr);
+
+    /**
+     * @brief Assign a value to a SSA variable in the current block.
+     * 
+     * @param variable The variable (declared with Eisdrache::declareSSA())
+     * @param value Value to assign
+     */
+    void assignSSA(Local &variable, Local &value);
+    /**
+     * @brief Assign a value to a SSA variable in the current block.
+     * 
+     * @param variable The variable (declared with Eisdrache::declareSSA())
+     * @param value Value to assign
+     */
+    void assignSSA(Local &variable, Constant *value);
+
+    /**
+     * @brief Seal a block once all of its predecessors are known.
+     *      Completes the phi nodes of SSA variables read in this block.
+     *      Blocks that are not sealed manually are sealed by Eisdrache::verifyFunc().
+     * 
+     * @param block The block
+     */
+    void sealBlock(BasicBlock *block);
+
     /**
      * @brief Load the value of a local variable.
      * 
@@ -661,17 +1078,187 @@ public:
      * 
      * @param local Local to be stored at (must be a pointer)
      * @param value Value to store in local
+     * @param nonTemporal (optional) The value is not read again soon, bypass the cache (!nontemporal)
      * @return StoreInst * - Store instruction returned by llvm::IRBuilder
      */
-    StoreInst *storeValue(Local &local, Local &value);
+    StoreInst *storeValue(Local &local, Local &value, bool nonTemporal = false);
     /**
      * @brief Store a value in a local variable.
      * 
      * @param local Local to be stored at (must be a pointer)
      * @param value Value to store in local
+     * @param nonTemporal (optional) The value is not read again soon, bypass the cache (!nontemporal)
      * @return StoreInst * - Store instruction returned by llvm::IRBuilder
      */
-    StoreInst *storeValue(Local &local, Constant *value);
+    StoreInst *storeValue(Local &local, Constant *value, bool nonTemporal = false);
+
+    /**
+     * @brief Atomically load the value at a pointer.
+     *      The type has to be a power of two of at least 8 bits wide.
+     * 
+     * @param ptr The pointer
+     * @param ordering (optional) Memory ordering (not Release or AcquireRelease)
+     * @param scope (optional) Synchronization scope
+     * @param name (optional) Name of the loaded value
+     * @return Local & 
+     */
+    Local &atomicLoad(Local &ptr, AtomicOrdering ordering = AtomicOrdering::SequentiallyConsistent, 
+        SyncScope::ID scope = SyncScope::System, std::string name = "");
+    
+    /**
+     * @brief Atomically store a value at a pointer.
+     *      The type has to be a power of two of at least 8 bits wide.
+     * 
+     * @param ptr The pointer
+     * @param value Value to store
+     * @param ordering (optional) Memory ordering (not Acquire or AcquireRelease)
+     * @param scope (optional) Synchronization scope
+     * @return StoreInst * 
+     */
+    StoreInst *atomicStore(Local &ptr, Local &value, AtomicOrdering ordering = AtomicOrdering::SequentiallyConsistent, 
+        SyncScope::ID scope = SyncScope::System);
+
+    /**
+     * @brief Atomically read, modify and write the value at a pointer (atomicrmw).
+     * 
+     * @param op Eisdrache::ADD, SUB (integers and floating points), AND, OR, XOR (integers), 
+     *      MIN, MAX (signed / unsigned depending on the type, or floating points since LLVM 15)
+     * @param ptr The pointer
+     * @param value The operand
+     * @param ordering (optional) Memory ordering
+     * @param scope (optional) Synchronization scope
+     * @param name (optional) Name of the result
+     * @return Local & - The value before the operation
+     */
+    Local &atomicOp(Op op, Local &ptr, Local &value, AtomicOrdering ordering = AtomicOrdering::SequentiallyConsistent, 
+        SyncScope::ID scope = SyncScope::System, std::string name = "");
+
+    /**
+     * @brief Atomically replace the value at a pointer (atomicrmw xchg).
+     * 
+     * @param ptr The pointer
+     * @param value The new value
+     * @param ordering (optional) Memory ordering
+     * @param scope (optional) Synchronization scope
+     * @param name (optional) Name of the result
+     * @return Local & - The value before the exchange
+     */
+    Local &atomicExchange(Local &ptr, Local &value, AtomicOrdering ordering = AtomicOrdering::SequentiallyConsistent, 
+        SyncScope::ID scope = SyncScope::System, std::string name = "");
+
+    /**
+     * @brief Atomically compare the value at a pointer with the expected value 
+     *      and replace it with the desired value if they are equal (cmpxchg).
+     *      Like C11 atomic_compare_exchange, the value read is written back to `expected`.
+     * 
+     * @param ptr The pointer
+     * @param expected Pointer to the expected value, updated with the actual value
+     * @param desired The new value
+     * @param success (optional) Memory ordering if the exchange succeeds (at least Monotonic)
+     * @param failure (optional) Memory ordering if it fails (at least Monotonic, not Release or AcquireRelease)
+     * @param weak (optional) Allow spurious failures (use in loops)
+     * @param scope (optional) Synchronization scope
+     * @param name (optional) Name of the result
+     * @return Local & - Boolean: true if the value was exchanged
+     */
+    Local &compareExchange(Local &ptr, Local &expected, Local &desired, 
+        AtomicOrdering success = AtomicOrdering::SequentiallyConsistent, 
+        AtomicOrdering failure = AtomicOrdering::SequentiallyConsistent, 
+        bool weak = false, SyncScope::ID scope = SyncScope::System, std::string name = "");
+
+    /**
+     * @brief Create a memory fence.
+     * 
+     * @param ordering Memory ordering (Acquire, Release, AcquireRelease or SequentiallyConsistent)
+     * @param scope (optional) Synchronization scope
+     * @return FenceInst * 
+     */
+    FenceInst *fence(AtomicOrdering ordering, SyncScope::ID scope = SyncScope::System);
+
+    /**
+     * @brief Prefetch the cache line of a pointer into the data cache (llvm.prefetch).
+     *      A hint only: prefetching an invalid address has no effect.
+     * 
+     * @param ptr The pointer
+     * @param write (optional) Prefetch for writing instead of reading
+     * @param locality (optional) Temporal locality from 0 (none, evict soon) to 3 (keep in all cache levels)
+     * @return CallInst * 
+     */
+    CallInst *prefetch(Local &ptr, bool write = false, unsigned locality = 3);
+
+    /**
+     * @brief Copy bytes between memory that does not overlap (llvm.memcpy).
+     * 
+     * @param dest Destination pointer
+     * @param src Source pointer
+     * @param bytes Amount of bytes
+     * @param isVolatile (optional) 
+     * @return CallInst * 
+     */
+    CallInst *memCopy(Local &dest, Local &src, Local &bytes, bool isVolatile = false);
+
+    /**
+     * @brief Copy bytes between memory that may overlap (llvm.memmove).
+     * 
+     * @param dest Destination pointer
+     * @param src Source pointer
+     * @param bytes Amount of bytes
+     * @param isVolatile (optional) 
+     * @return CallInst * 
+     */
+    CallInst *memMove(Local &dest, Local &src, Local &bytes, bool isVolatile = false);
+
+    /**
+     * @brief Set bytes to a value (llvm.memset).
+     * 
+     * @param dest Destination pointer
+     * @param value The byte (i8)
+     * @param bytes Amount of bytes
+     * @param isVolatile (optional) 
+     * @return CallInst * 
+     */
+    CallInst *memSet(Local &dest, Local &value, Local &bytes, bool isVolatile = false);
+
+    /**
+     * @brief Mark a loaded pointer as never null (!nonnull).
+     * 
+     * @param load The loaded pointer (returned by Eisdrache::Local::loadValue())
+     */
+    void markNonNull(Local &load);
+    
+    /**
+     * @brief Mark a loaded pointer as dereferenceable (!dereferenceable or !dereferenceable_or_null).
+     * 
+     * @param load The loaded pointer (returned by Eisdrache::Local::loadValue())
+     * @param bytes Amount of bytes that can be dereferenced
+     * @param orNull (optional) The pointer may also be null
+     */
+    void markDereferenceable(Local &load, uint64_t bytes, bool orNull = false);
+    
+    /**
+     * @brief Mark a loaded pointer as aligned (!align).
+     * 
+     * @param load The loaded pointer (returned by Eisdrache::Local::loadValue())
+     * @param align Alignment of the pointee in bytes (power of two)
+     */
+    void markAlign(Local &load, uint64_t align);
+
+    /**
+     * @brief Mark the range of a loaded integer (!range).
+     * 
+     * @param load The loaded integer (returned by Eisdrache::Local::loadValue())
+     * @param low Lowest possible value
+     * @param high Highest possible value + 1 (wraps if lower than low)
+     */
+    void markRange(Local &load, uint64_t low, uint64_t high);
+
+    /**
+     * @brief Mark a load as invariant (!invariant.load): 
+     *      The memory holds the same value wherever it is dereferenceable, so the load can be hoisted freely.
+     * 
+     * @param load The loaded value (returned by Eisdrache::Local::loadValue())
+     */
+    void markInvariant(Local &load);
 
     /**
      * @brief Create an instruction for the future assignment of a local
@@ -784,6 +1371,7 @@ public:
 
     /**
      * @brief Create a binary operation.
+     *      Integer divisions and remainders by constants are reduced to shifts and multiplications.
      * 
      * @param op Operation
      * @param LHS Left-Hand-Side
@@ -793,6 +1381,17 @@ public:
      */
     Local &binaryOp(Op op, Local &LHS, Local &RHS, std::string name = ""); 
 
+    /**
+     * @brief Create an integer division that is known to have no remainder.
+     *      Divisions by constants are reduced to a shift and a multiplication with the inverse.
+     * 
+     * @param LHS Left-Hand-Side
+     * @param RHS Right-Hand-Side
+     * @param name (optional) Name of the result
+     * @return Local & - Result
+     */
+    Local &exactDiv(Local &LHS, Local &RHS, std::string name = "");
+
     /**
      * @brief Bitcast a pointer to a type.
      * 
@@ -819,6 +1418,65 @@ public:
      * @return BranchInst *
      */
     BranchInst *jump(Local &condition, BasicBlock *then, BasicBlock *else_ = nullptr);
+    /**
+     * @brief Jump to `then` if condition is true, else jump to `else´.
+     *      Annotates the branch with weights (2000:1 like llvm.expect), 
+     *      so the likely block is placed as fall-through.
+     * 
+     * @param condition The condition
+     * @param then The `then` block
+     * @param else_ The `else` block
+     * @param likely Wether the condition is likely or unlikely to be true
+     * @return BranchInst *
+     */
+    BranchInst *jump(Local &condition, BasicBlock *then, BasicBlock *else_, Branch likely);
+    /**
+     * @brief Jump to `then` if condition is true, else jump to `else´.
+     * 
+     * @param condition The condition
+     * @param then The `then` block
+     * @param else_ The `else` block
+     * @param thenWeight Profile weight of the `then` block
+     * @param elseWeight Profile weight of the `else` block
+     * @return BranchInst *
+     */
+    BranchInst *jump(Local &condition, BasicBlock *then, BasicBlock *else_, uint32_t thenWeight, uint32_t elseWeight);
+
+    /**
+     * @brief Tell LLVM which value an expression most likely has (llvm.expect).
+     * 
+     * @param value The expression
+     * @param expected The expected value
+     * @param name (optional) Name of the result
+     * @return Local & - The value of the expression
+     */
+    Local &expect(Local &value, Constant *expected, std::string name = "");
+
+    /**
+     * @brief Jump to the block of the matching case or to the default block.
+     * 
+     * @param condition The integer to switch on
+     * @param default_ Block if no case matches
+     * @param cases Pairs of case value and block
+     * @param weights (optional) Profile weights, first for the default block, then for each case
+     * @return SwitchInst * 
+     */
+    SwitchInst *createSwitch(Local &condition, BasicBlock *default_, 
+        std::vector<std::pair<ConstantInt *, BasicBlock *>> cases, std::vector<uint32_t> weights = {});
+
+    /**
+     * @brief Map an integer to a constant. 
+     *      Dense cases are lowered to a load from a constant lookup table without branching,
+     *      sparse cases to a switch.
+     * 
+     * @param condition The integer
+     * @param cases Pairs of case value and result
+     * @param default_ Result if no case matches
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &createLookup(Local &condition, std::vector<std::pair<ConstantInt *, Constant *>> cases, 
+        Constant *default_, std::string name = "");
 
     /**
      * @brief Type cast a value.
@@ -871,6 +1529,298 @@ public:
      */
     Local &unaryOp(Op op, Local &expr, std::string name = "");
 
+    /**
+     * @brief Choose between two values without branching.
+     * 
+     * @param condition The condition (boolean or vector of booleans)
+     * @param then Value if condition is true
+     * @param else_ Value if condition is false
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &select(Local &condition, Local &then, Local &else_, std::string name = "");
+
+    /**
+     * @brief Get the minimum of two values (smin, umin or minnum depending on the type).
+     * 
+     * @param LHS Left-Hand-Side
+     * @param RHS Right-Hand-Side
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &min(Local &LHS, Local &RHS, std::string name = "");
+
+    /**
+     * @brief Get the maximum of two values (smax, umax or maxnum depending on the type).
+     * 
+     * @param LHS Left-Hand-Side
+     * @param RHS Right-Hand-Side
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &max(Local &LHS, Local &RHS, std::string name = "");
+
+    /**
+     * @brief Get the absolute value (abs for signed integers, fabs for floating points).
+     *      Unsigned integers are returned unchanged.
+     * 
+     * @param expr The expression
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &abs(Local &expr, std::string name = "");
+
+    /**
+     * @brief Clamp a value to a range: min(max(value, low), high).
+     * 
+     * @param value The value
+     * @param low Lower bound
+     * @param high Upper bound
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &clamp(Local &value, Local &low, Local &high, std::string name = "");
+
+    /**
+     * @brief Count the set bits of an integer (llvm.ctpop).
+     * 
+     * @param expr The integer
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &popCount(Local &expr, std::string name = "");
+
+    /**
+     * @brief Count the leading zero bits of an integer (llvm.ctlz).
+     * 
+     * @param expr The integer
+     * @param zeroIsPoison (optional) The result is poison if expr is 0 (otherwise the bit width)
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &countLeadingZeros(Local &expr, bool zeroIsPoison = false, std::string name = "");
+
+    /**
+     * @brief Count the trailing zero bits of an integer (llvm.cttz).
+     * 
+     * @param expr The integer
+     * @param zeroIsPoison (optional) The result is poison if expr is 0 (otherwise the bit width)
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &countTrailingZeros(Local &expr, bool zeroIsPoison = false, std::string name = "");
+
+    /**
+     * @brief Reverse the bytes of an integer (llvm.bswap).
+     *      The bit width has to be a multiple of 16.
+     * 
+     * @param expr The integer
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &byteSwap(Local &expr, std::string name = "");
+
+    /**
+     * @brief Concatenate two integers (high:low), shift left and return the high half (llvm.fshl).
+     *      Rotates left if high and low are the same value. The shift amount is taken modulo the bit width.
+     * 
+     * @param high The high half
+     * @param low The low half
+     * @param amount Shift amount
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &funnelShiftLeft(Local &high, Local &low, Local &amount, std::string name = "");
+
+    /**
+     * @brief Concatenate two integers (high:low), shift right and return the low half (llvm.fshr).
+     *      Rotates right if high and low are the same value. The shift amount is taken modulo the bit width.
+     * 
+     * @param high The high half
+     * @param low The low half
+     * @param amount Shift amount
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &funnelShiftRight(Local &high, Local &low, Local &amount, std::string name = "");
+
+    /**
+     * @brief Fused multiply-add a * b + c with a single rounding (llvm.fma).
+     * 
+     * @param a Multiplicand
+     * @param b Multiplier
+     * @param c Addend
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &fma(Local &a, Local &b, Local &c, std::string name = "");
+
+    /**
+     * @brief Multiply-add a * b + c, fused only if that is faster on the target (llvm.fmuladd).
+     * 
+     * @param a Multiplicand
+     * @param b Multiplier
+     * @param c Addend
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &fmulAdd(Local &a, Local &b, Local &c, std::string name = "");
+
+    /**
+     * @brief Get the square root of a floating point (llvm.sqrt).
+     * 
+     * @param expr The floating point
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &sqrt(Local &expr, std::string name = "");
+
+    /**
+     * @brief Saturating integer operation, clamps to the range of the type instead of wrapping.
+     *      Signed or unsigned depending on the type of LHS.
+     * 
+     * @param op Eisdrache::ADD (llvm.sadd.sat / llvm.uadd.sat), 
+     *      Eisdrache::SUB (llvm.ssub.sat / llvm.usub.sat) or Eisdrache::LSH (llvm.sshl.sat / llvm.ushl.sat)
+     * @param LHS Left hand side
+     * @param RHS Right hand side
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &saturatingOp(Op op, Local &LHS, Local &RHS, std::string name = "");
+
+    /**
+     * @brief Overflow checked integer operation (llvm.sadd.with.overflow, llvm.umul.with.overflow, ...).
+     *      Signed or unsigned depending on the type of LHS.
+     *      Jumps to the overflow block if the operation overflowed (weighted as unlikely),
+     *      else continues in a new block, which becomes the insertion point.
+     * 
+     * @param op Eisdrache::ADD, Eisdrache::SUB or Eisdrache::MUL
+     * @param LHS Left hand side
+     * @param RHS Right hand side
+     * @param overflow Block to jump to on overflow
+     * @param name (optional) Name of the result
+     * @return Local & - The result (wrapped on overflow)
+     */
+    Local &checkedOp(Op op, Local &LHS, Local &RHS, BasicBlock *overflow, std::string name = "");
+
+    /**
+     * @brief Create a vector with every element set to a value.
+     * 
+     * @param value The value
+     * @param count Amount of elements
+     * @param scalable (optional) Create a scalable vector (vscale x count elements)
+     * @param name (optional) Name of the vector
+     * @return Local & 
+     */
+    Local &splat(Local &value, size_t count, bool scalable = false, std::string name = "");
+
+    /**
+     * @brief Insert a value into a vector.
+     * 
+     * @param vector The vector
+     * @param value The value
+     * @param index Index of the element
+     * @param name (optional) Name of the new vector
+     * @return Local & 
+     */
+    Local &insertElement(Local &vector, Local &value, size_t index, std::string name = "");
+
+    /**
+     * @brief Insert a value into a vector.
+     * 
+     * @param vector The vector
+     * @param value The value
+     * @param index Index of the element
+     * @param name (optional) Name of the new vector
+     * @return Local & 
+     */
+    Local &insertElement(Local &vector, Local &value, Local &index, std::string name = "");
+
+    /**
+     * @brief Extract an element from a vector.
+     * 
+     * @param vector The vector
+     * @param index Index of the element
+     * @param name (optional) Name of the element
+     * @return Local & 
+     */
+    Local &extractElement(Local &vector, size_t index, std::string name = "");
+
+    /**
+     * @brief Extract an element from a vector.
+     * 
+     * @param vector The vector
+     * @param index Index of the element
+     * @param name (optional) Name of the element
+     * @return Local & 
+     */
+    Local &extractElement(Local &vector, Local &index, std::string name = "");
+
+    /**
+     * @brief Shuffle the elements of two vectors into a new vector.
+     * 
+     * @param first The first vector
+     * @param second The second vector
+     * @param mask Index into the concatenation of both vectors for every element of the result (-1 = poison)
+     * @param name (optional) Name of the new vector
+     * @return Local & 
+     */
+    Local &shuffleVector(Local &first, Local &second, std::vector<int> mask, std::string name = "");
+
+    /**
+     * @brief Reduce the elements of a vector to a single value (llvm.vector.reduce.*).
+     * 
+     * @param op The operation (ADD, MUL, AND, OR, XOR, MIN, MAX; ADD, MUL, MIN, MAX for floating points)
+     * @param vector The vector
+     * @param ordered (optional) Keep the order of floating point additions and multiplications, 
+     *      otherwise they may be reassociated
+     * @param name (optional) Name of the result
+     * @return Local & 
+     */
+    Local &reduce(Op op, Local &vector, bool ordered = false, std::string name = "");
+
+    /**
+     * @brief Load a vector from memory. Only the elements enabled in the mask are read.
+     * 
+     * @param ptr Pointer to the first element
+     * @param mask Vector of booleans
+     * @param name (optional) Name of the loaded vector
+     * @return Local & - Loaded vector, disabled elements are poison
+     */
+    Local &maskedLoad(Local &ptr, Local &mask, std::string name = "");
+
+    /**
+     * @brief Store a vector in memory. Only the elements enabled in the mask are written.
+     * 
+     * @param ptr Pointer to the first element
+     * @param value The vector
+     * @param mask Vector of booleans
+     * @return CallInst * 
+     */
+    CallInst *maskedStore(Local &ptr, Local &value, Local &mask);
+
+    /**
+     * @brief Load the elements of a vector from a vector of pointers.
+     *      Only the elements enabled in the mask are read.
+     * 
+     * @param ptrs Vector of pointers (e.g. from Eisdrache::getArrayElement() with a vector of indices)
+     * @param mask Vector of booleans
+     * @param name (optional) Name of the loaded vector
+     * @return Local & - Loaded vector, disabled elements are poison
+     */
+    Local &gather(Local &ptrs, Local &mask, std::string name = "");
+
+    /**
+     * @brief Store the elements of a vector at a vector of pointers.
+     *      Only the elements enabled in the mask are written.
+     * 
+     * @param ptrs Vector of pointers
+     * @param value The vector
+     * @param mask Vector of booleans
+     * @return CallInst * 
+     */
+    CallInst *scatter(Local &ptrs, Local &value, Local &mask);
+
     /// GETTER ///
 
     /**
@@ -933,11 +1883,114 @@ public:
      */
     void setParent(Func *func);
 
+    /**
+     * @brief Toggle inlining by the builder: Eisdrache::Func::call() splices the body of trivial callees
+     *      (alwaysinline, a single block, no allocas) into the caller instead of creating a call,
+     *      so accessors are inlined even without a pass pipeline.
+     * 
+     * @param enabled 
+     */
+    void setBuilderInlining(bool enabled);
+
+    /**
+     * @brief Toggle type-based alias analysis metadata (!tbaa) on loads and stores (disabled by default).
+     *      Only enable it if memory is never accessed through a pointer of a different type 
+     *      (e.g. bit casted pointers or reused i8 buffers), otherwise the accesses may be reordered or removed.
+     * 
+     * @param enabled 
+     */
+    void setTBAA(bool enabled);
+
 private:
     Eisdrache(LLVMContext *context, Module *module, IRBuilder<> *builder, std::string targetTriple);
 
     static std::nullptr_t complain(std::string);
 
+    /**
+     * @brief Create an alloca instruction at the top of the entry block of the current parent,
+     *      so every local is allocated once per call and visible to mem2reg / SROA.
+     * 
+     * @param type Type to allocate
+     * @param name (optional) Name of the AllocaInst *
+     * @return AllocaInst * 
+     */
+    AllocaInst *createAlloca(Type *type, std::string name = "");
+
+    // create an integer division or remainder, strength reduce divisions by constants
+    Value *createDivision(Value *LHS, Value *RHS, bool isSigned, bool remainder, bool exact, std::string name);
+    // multiply and keep the high half of the result
+    Value *createMulHigh(Value *LHS, const APInt &RHS, bool isSigned, std::string name);
+
+    // create an intrinsic overloaded on the type of the first operand, check that all operands have the same type
+    Local &createIntrinsic(Intrinsic::ID id, std::vector<Local *> operands, bool floating, std::string caller, std::string name);
+
+    // get the flags of the innermost WrapScope (all disabled without one)
+    WrapScope::Flags getWrapFlags();
+
+    // check the pointee of an atomic access and get its alignment (the size of the type)
+    Align getAtomicAlign(Local &ptr, std::string caller);
+
+    /**
+     * @brief Splice the body of a trivial callee at the insertion point.
+     * 
+     * @param callee The callee
+     * @param args Arguments of the call
+     * @param name Name of the result
+     * @param result The returned value (nullptr if void)
+     * @return true - The body was spliced.
+     * @return false - The callee is not trivial, no code was created.
+     */
+    bool spliceCall(Function *callee, ValueVec args, std::string name, Value *&result);
+
+    // create a call with the calling convention of the callee
+    CallInst *createCall(Function *callee, ValueVec args, std::string name = "");
+
+    // set the calling convention of a function and all of its call sites
+    void setCallingConv(Function *func, CallingConv::ID conv);
+
+    // get the alignment of the pointee of a pointer for memory intrinsics (1 for void)
+    MaybeAlign getPointeeAlign(Local &ptr, std::string caller);
+
+    // get the load instruction wrapped by a local
+    LoadInst *getLoadInst(Local &load, std::string caller);
+
+    // attach TBAA and the metadata of the active scopes to a load or store of a pointer
+    void annotateAccess(Instruction *inst, Value *ptr);
+
+    /**
+     * @brief Get the TBAA type node of a type.
+     *      Scalars are children of "omnipotent char" (i8), which aliases every type.
+     *      Structs are struct type nodes with the offsets of their fields.
+     * 
+     * @param type The type
+     * @return MDNode * 
+     */
+    MDNode *getTBAATypeNode(Type *type);
+    /**
+     * @brief Get the TBAA access tag for an access of a type at a pointer.
+     *      Pointers to fields of a struct (constant GEP indices) get a struct-path tag.
+     * 
+     * @param accessTy The loaded or stored type
+     * @param ptr The pointer
+     * @return MDNode * - nullptr for vectors and aggregates
+     */
+    MDNode *getTBAATag(Type *accessTy, Value *ptr);
+
+    // load a mask and check that it is a vector of booleans
+    Value *loadMask(Local &mask, std::string caller);
+
+    // load the length of a memory intrinsic and check that it is an integer
+    Value *loadBytes(Local &bytes, std::string caller);
+
+    /// SSA CONSTRUCTION ///
+
+    Value *readSSA(int64_t variable, BasicBlock *block);
+    Value *readSSARecursive(int64_t variable, BasicBlock *block);
+    void writeSSA(int64_t variable, BasicBlock *block, Value *value);
+    PHINode *createPhi(int64_t variable, BasicBlock *block);
+    Value *addPhiOperands(int64_t variable, PHINode *phi);
+    Value *tryRemoveTrivialPhi(PHINode *phi);
+
     LLVMContext *context;
     Module *module;
     IRBuilder<> *builder;
@@ -947,6 +2000,20 @@ private:
     Func::Map functions;
     Struct::Map structs;
     Ty::Vec types;
+
+    std::vector<std::pair<std::string, Type *>> ssaVariables;                   // name and type of each SSA variable
+    // keyed by ValueMap, so the entries of erased blocks are dropped
+    ValueMap<BasicBlock *, std::map<int64_t, WeakTrackingVH>> ssaDefs;         // current definitions in each block
+    ValueMap<BasicBlock *, std::vector<std::pair<int64_t, WeakVH>>> incompletePhis;
+    ValueMap<BasicBlock *, bool> sealedBlocks;
+
+    std::vector<LifetimeScope *> lifetimeScopes;
+    bool builderInlining = false;
+    std::vector<WrapScope *> wrapScopes;
+    std::vector<AliasScope *> aliasScopes;
+
+    bool tbaa = false;
+    std::map<Type *, MDNode *> tbaaTypes;
 };
 
 } // namespace llvm
\ No newline at end of file